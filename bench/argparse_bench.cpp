@@ -0,0 +1,302 @@
+/* @author: Morris Franken
+ * Benchmarks for constructing Args objects, parsing commandlines and converting values, to catch performance regressions.
+ * Synthetic schemas of 10 to 10k options are parsed from commandlines of 10 to 1M tokens, and compared to a hand-written getopt_long parser.
+ * Batches of commandlines are parsed by a frozen parser on an increasing number of threads.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+
+#if __has_include(<getopt.h>)
+#include <getopt.h>
+#define HAS_GETOPT_LONG
+#endif
+
+// Count all heap allocations, to report the number of allocations per parse
+static std::atomic<size_t> allocation_count{0};
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"  // free() is the counterpart of the malloc() in the replaced operator new, which GCC can not see once both are inlined
+#endif
+void *operator new(size_t size) {
+    allocation_count++;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void *operator new(size_t size, std::align_val_t alignment) {   // used by std::pmr::new_delete_resource
+    allocation_count++;
+    const size_t a = (size_t)alignment;
+#ifdef _WIN32
+    if (void *p = _aligned_malloc(size ? size : 1, a))
+#else
+    if (void *p = std::aligned_alloc(a, (size + a - 1) / a * a + (size == 0 ? a : 0)))
+#endif
+        return p;
+    throw std::bad_alloc();
+}
+#ifdef _WIN32
+void operator delete(void *p, std::align_val_t) noexcept { _aligned_free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { _aligned_free(p); }
+#else
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+struct BenchArgs : public argparse::Args {
+    size_t &max_options             = kwarg("max-options", "The largest number of options in a generated schema").set_default(10000);
+    size_t &max_tokens              = kwarg("max-tokens", "The largest number of tokens in a generated commandline").set_default(1000000);
+    int &repeat                     = kwarg("r,repeat", "Number of repetitions, the fastest is reported").set_default(3);
+
+    void welcome() override {
+        std::cout << "Benchmarks for argparse, reporting construction, parse and conversion times" << std::endl;
+    }
+};
+
+enum class OptionType { INT, DOUBLE, STRING, VECTOR, FLAG };
+inline OptionType option_type(size_t i) { return OptionType(i % 5); }
+inline std::string option_name(size_t i) { return "option" + std::to_string(i); }
+
+// Args with `n` generated options, cycling through the option types
+struct GeneratedArgs : public argparse::Args {
+    std::vector<int*> ints;
+    std::vector<double*> doubles;
+    std::vector<std::string*> strings;
+    std::vector<std::vector<int>*> vectors;
+    std::vector<bool*> flags;
+
+    explicit GeneratedArgs(size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            const std::string key = option_name(i);
+            switch (option_type(i)) {
+                case OptionType::INT:       ints.emplace_back(&(int&)kwarg(key, "An int").set_default(0)); break;
+                case OptionType::DOUBLE:    doubles.emplace_back(&(double&)kwarg(key, "A double").set_default(0.0)); break;
+                case OptionType::STRING:    strings.emplace_back(&(std::string&)kwarg(key, "A string").set_default("")); break;
+                case OptionType::VECTOR:    vectors.emplace_back(&(std::vector<int>&)kwarg(key, "A vector").set_default("")); break;
+                case OptionType::FLAG:      flags.emplace_back(&(bool&)flag(key, "A flag")); break;
+            }
+        }
+    }
+};
+
+// A generated commandline, which owns its tokens
+struct Commandline {
+    std::vector<std::string> tokens;
+    std::vector<char*> argv;
+
+    Commandline(size_t n_options, size_t n_tokens) {
+        tokens.emplace_back("argparse_bench");
+        for (size_t i = 0; tokens.size() <= n_tokens; i++) {
+            const size_t option = i % n_options;
+            tokens.emplace_back("--" + option_name(option));
+            switch (option_type(option)) {
+                case OptionType::INT:       tokens.emplace_back(std::to_string(i)); break;
+                case OptionType::DOUBLE:    tokens.emplace_back("0.5"); break;
+                case OptionType::STRING:    tokens.emplace_back("value"); break;
+                case OptionType::VECTOR:    tokens.emplace_back("1,2,3"); break;
+                case OptionType::FLAG:      break;
+            }
+        }
+        for (std::string &token : tokens)
+            argv.emplace_back(token.data());
+    }
+
+    [[nodiscard]] int argc() const { return (int)argv.size(); }
+};
+
+// Fastest time in milliseconds of `repeat` runs of `f`
+template <typename F> double measure(int repeat, F &&f) {
+    double best = 1e300;
+    for (int r = 0; r < repeat; r++) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+// Fastest time in milliseconds of `repeat` runs of `f(state)`, where a fresh state is made by `setup` before the clock starts and destroyed after it stops
+template <typename S, typename F> double measure(int repeat, S &&setup, F &&f) {
+    double best = 1e300;
+    for (int r = 0; r < repeat; r++) {
+        auto state = setup();
+        const auto start = std::chrono::steady_clock::now();
+        f(state);
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+#ifdef HAS_GETOPT_LONG
+// Hand-written getopt_long parser for the same generated options, as a baseline
+struct GetoptBaseline {
+    std::vector<std::string> names;
+    std::vector<option> options;
+    std::vector<int> ints;
+    std::vector<double> doubles;
+    std::vector<std::string> strings;
+    std::vector<std::vector<int>> vectors;
+    std::vector<bool> flags;
+
+    explicit GetoptBaseline(size_t n) : ints(n), doubles(n), strings(n), vectors(n), flags(n) {
+        for (size_t i = 0; i < n; i++)
+            names.emplace_back(option_name(i));
+        for (size_t i = 0; i < n; i++)
+            options.push_back({names[i].c_str(), option_type(i) == OptionType::FLAG ? no_argument : required_argument, nullptr, 0});
+        options.push_back({nullptr, 0, nullptr, 0});
+    }
+
+    void parse(std::vector<char*> argv) {   // getopt_long may permute argv, so it works on a copy
+        optind = 0;
+        int idx = 0;
+        while (getopt_long((int)argv.size(), argv.data(), "", options.data(), &idx) == 0) {
+            switch (option_type(idx)) {
+                case OptionType::INT:       ints[idx] = (int)std::strtol(optarg, nullptr, 10); break;
+                case OptionType::DOUBLE:    doubles[idx] = std::strtod(optarg, nullptr); break;
+                case OptionType::STRING:    strings[idx] = optarg; break;
+                case OptionType::VECTOR: {
+                    std::vector<int> &v = vectors[idx];
+                    v.clear();
+                    for (char *p = optarg; *p != '\0';) {
+                        v.emplace_back((int)std::strtol(p, &p, 10));
+                        if (*p == ',')
+                            p++;
+                    }
+                    break;
+                }
+                case OptionType::FLAG:      flags[idx] = true; break;
+            }
+        }
+    }
+};
+#endif
+
+#ifdef HAS_MAGIC_ENUM
+enum class Mode { FAST, SLOW, BALANCED, EXHAUSTIVE, INTERACTIVE, BATCH, STREAMING, OFFLINE };
+#endif
+
+void bench_parse(const BenchArgs &args) {
+    std::cout << std::endl << argparse::bold("Construction and parsing") << std::endl;
+    std::cout << std::setw(9) << "options" << std::setw(10) << "tokens" << std::setw(16) << "construct [ms]" << std::setw(12) << "parse [ms]"
+              << std::setw(14) << "reparse [ms]" << std::setw(14) << "allocs/parse" << std::setw(14) << "getopt [ms]" << std::endl;
+
+    std::vector<size_t> token_counts;
+    for (size_t n_tokens = 10; n_tokens < args.max_tokens; n_tokens *= 100)
+        token_counts.push_back(n_tokens);
+    token_counts.push_back(args.max_tokens);    // the largest commandline is always measured, also when it is not a step of 100
+
+    for (size_t n_options = 10; n_options <= args.max_options; n_options *= 10) {
+        for (size_t n_tokens : token_counts) {
+            const Commandline commandline(n_options, n_tokens);
+
+            const double construct_ms = measure(args.repeat, [&] { GeneratedArgs generated(n_options); });
+            const double parse_ms = measure(args.repeat, [&] { return std::make_unique<GeneratedArgs>(n_options); }, [&](const std::unique_ptr<GeneratedArgs> &generated) {
+                generated->parse(commandline.argc(), commandline.argv.data(), true);
+            });
+
+            GeneratedArgs generated(n_options);
+            generated.reparse(commandline.argc(), commandline.argv.data(), true);   // warm-up
+            const size_t allocations_before = allocation_count;
+            const double reparse_ms = measure(args.repeat, [&] { generated.reparse(commandline.argc(), commandline.argv.data(), true); });
+            const double allocations = double(allocation_count - allocations_before) / args.repeat;
+
+            std::cout << std::setw(9) << n_options << std::setw(10) << n_tokens << std::fixed << std::setprecision(3)
+                      << std::setw(16) << construct_ms << std::setw(12) << parse_ms << std::setw(14) << reparse_ms
+                      << std::setw(14) << std::setprecision(1) << allocations << std::setprecision(3);
+#ifdef HAS_GETOPT_LONG
+            if (n_options * n_tokens <= 100000000) {    // getopt_long searches the options linearly, which becomes too slow to measure
+                GetoptBaseline baseline(n_options);
+                std::cout << std::setw(14) << measure(args.repeat, [&] { baseline.parse(commandline.argv); });
+            } else {
+                std::cout << std::setw(14) << "-";
+            }
+#endif
+            std::cout << std::endl;
+        }
+    }
+}
+
+void bench_conversion(const BenchArgs &args) {
+    std::cout << std::endl << argparse::bold("Conversion throughput") << std::endl;
+    const size_t n = std::max<size_t>(args.max_tokens, 1000);
+
+    std::vector<std::string> ints, doubles, names;
+    std::string list;
+    for (size_t i = 0; i < n; i++) {
+        ints.emplace_back(std::to_string(i * 7919 % 1000000007));   // within the range of an int
+        doubles.emplace_back(std::to_string(i * 0.25));
+        names.emplace_back(i % 2 ? "photos/2024/IMG_" + ints.back() + ".jpg" : "fotos/gr\xc3\xbc\xc3\x9f" "e_" + ints.back() + "_\xe6\x9d\xb1\xe4\xba\xac.jpg");
+        list += ints.back() + ',';
+    }
+
+    long long sink = 0;
+    const double int_ms = measure(args.repeat, [&] { for (const std::string &v : ints) sink += argparse::get<int>(v); });
+    const double double_ms = measure(args.repeat, [&] { for (const std::string &v : doubles) sink += (long long)argparse::get<double>(v); });
+    const double wstring_ms = measure(args.repeat, [&] { for (const std::string &v : names) sink += (long long)argparse::get<std::wstring>(v).size(); });
+    const double vector_ms = measure(args.repeat, [&] { sink += (long long)argparse::get<std::vector<int>>(list).size(); });
+    argparse::parallel_threshold = SIZE_MAX;
+    const double vector_single_ms = measure(args.repeat, [&] { sink += (long long)argparse::get<std::vector<int>>(list).size(); });
+    argparse::parallel_threshold = 1 << 16;
+    std::cout << std::setw(24) << "get<int> : " << std::setw(10) << n / int_ms / 1000 << " M/s" << std::endl;
+    std::cout << std::setw(24) << "get<double> : " << std::setw(10) << n / double_ms / 1000 << " M/s" << std::endl;
+    std::cout << std::setw(24) << "get<std::wstring> : " << std::setw(10) << n / wstring_ms / 1000 << " M/s" << std::endl;
+    std::cout << std::setw(24) << "get<std::vector<int>> : " << std::setw(10) << n / vector_ms / 1000 << " M elements/s" << std::endl;
+    std::cout << std::setw(24) << "(on 1 thread) : " << std::setw(10) << n / vector_single_ms / 1000 << " M elements/s" << std::endl;
+
+#ifdef HAS_MAGIC_ENUM
+    std::vector<std::string> modes;
+    for (size_t i = 0; i < n; i++)
+        modes.emplace_back(argparse::to_lower(magic_enum::enum_names<Mode>()[i % magic_enum::enum_count<Mode>()]));
+    const double enum_ms = measure(args.repeat, [&] { for (const std::string &v : modes) sink += (long long)argparse::get<Mode>(v); });
+    std::cout << std::setw(24) << "get<enum> : " << std::setw(10) << n / enum_ms / 1000 << " M/s" << std::endl;
+#endif
+    if (sink == 42)
+        std::cout << std::endl;     // keep the conversions from being optimized away
+}
+
+void bench_batch(const BenchArgs &args) {
+    std::cout << std::endl << argparse::bold("Batch parsing with a frozen parser") << std::endl;
+    std::cout << std::setw(9) << "threads" << std::setw(14) << "commandlines" << std::setw(12) << "time [ms]" << std::setw(18) << "commandlines/s" << std::endl;
+
+    const size_t n_options = std::min<size_t>(args.max_options, 100);
+    const size_t n_commandlines = std::max<size_t>(args.max_tokens / 20, 1000);
+    std::vector<std::vector<std::string>> commandlines;
+    commandlines.reserve(n_commandlines);
+    for (size_t i = 0; i < n_commandlines; i++)
+        commandlines.emplace_back(Commandline(n_options, 20).tokens);
+
+    const argparse::FrozenArgs parser(std::make_shared<GeneratedArgs>(n_options));
+    const size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t n_threads = 1; n_threads <= max_threads; n_threads = n_threads < max_threads ? std::min(n_threads * 2, max_threads) : n_threads + 1) {
+        const double ms = measure(args.repeat, [&] { (void)parser.parse_batch(commandlines, n_threads); });
+        std::cout << std::setw(9) << n_threads << std::setw(14) << n_commandlines << std::fixed << std::setprecision(3)
+                  << std::setw(12) << ms << std::setw(18) << std::setprecision(0) << n_commandlines / ms * 1000 << std::setprecision(3) << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchArgs args;
+    args.parse(argc, argv, false);
+
+    bench_parse(args);
+    bench_conversion(args);
+    bench_batch(args);
+    return 0;
+}
@@ -25,23 +25,35 @@
 // ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 // DEALINGS IN THE SOFTWARE.
 #include <cctype>              // for isdigit, tolower
+#include <cerrno>              // for errno, ERANGE
+#include <charconv>            // for from_chars
+#include <cmath>               // for isinf
+#include <limits>              // for numeric_limits
+#include <system_error>        // for errc
 #include <sstream>
-#include <cstdlib>             // for size_t, exit
+#include <cstdlib>             // for size_t, exit, abort
 #include <algorithm>           // for max, transform, copy, min
+#include <array>               // for array
+#include <atomic>              // for atomic, for parallel_threshold
+#include <bitset>              // for bitset (popcount)
+#include <cstdint>             // for uint64_t
+#include <cstring>             // for memcpy, for loading binary arrays
+#include <exception>           // for exception_ptr, for parallel_for
 #include <iomanip>             // for operator<<, setw
 #include <iostream>            // for operator<<, basic_ostream, endl, ostream
-#include <iterator>            // for ostream_iterator
 #include <map>                 // for operator!=, map, _Rb_tree_iterator
 #include <memory>              // for allocator, shared_ptr, __shared_ptr_ac...
+#include <memory_resource>     // for pmr::memory_resource, pmr::polymorphic_allocator
+#include <mutex>               // for mutex, lock_guard, for parallel_for
 #include <optional>            // for optional, nullopt
 #include <stdexcept>           // for runtime_error, invalid_argument
 #include <filesystem>          // for getting program_name from path
 #include <string>              // for string, operator+, basic_string, char_...
+#include <string_view>         // for string_view
+#include <thread>              // for thread, hardware_concurrency, for parallel_for
 #include <type_traits>         // for declval, false_type, true_type, is_enum
 #include <utility>             // for move, pair
 #include <vector>              // for vector
-#include <codecvt>             // for std::wstring_convert
-#include <locale>              // for std::wstring_convert
 
 // for enum_entries
 #if __has_include(<magic_enum.hpp>)
@@ -52,10 +64,55 @@
 #define HAS_MAGIC_ENUM
 #endif
 
+// for vectorized splitting of comma-separated values, define ARGPARSE_NO_SIMD to use the scalar implementation only
+#if !defined(ARGPARSE_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define ARGPARSE_HAS_AVX2
+#define ARGPARSE_HAS_SSE2
+#elif !defined(ARGPARSE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define ARGPARSE_HAS_SSE2
+#endif
+#if defined(ARGPARSE_HAS_SSE2) && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>            // for _BitScanForward
+#endif
+
+// for memory-mapping response files, systems without mmap read the file into memory instead
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>             // for open, O_RDONLY
+#include <sys/mman.h>          // for mmap, munmap
+#include <sys/stat.h>          // for fstat
+#include <unistd.h>            // for close
+#define ARGPARSE_HAS_MMAP
+#else
+#include <fstream>             // for ifstream
+#endif
+
+#ifdef ARGPARSE_ENABLE_STATS
+#include <chrono>              // for steady_clock, for ParseStats
+#endif
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define ARGPARSE_HAS_EXCEPTIONS
+#define ARGPARSE_THROW(exception) throw exception
+#else   // without exceptions, errors that can only be reported by throwing terminate the program, use `Args::try_parse` to handle errors instead
+#define ARGPARSE_THROW(exception) (std::cerr << (exception).what() << std::endl, std::abort())
+#endif
+
+// without exceptions, std::thread can only report a thread that can not be started by terminating, so threads are started through pthreads instead
+#if !defined(ARGPARSE_HAS_EXCEPTIONS) && __has_include(<pthread.h>)
+#include <pthread.h>           // for pthread_create, pthread_join
+#define ARGPARSE_HAS_PTHREAD
+#endif
+
 #define ARGPARSE_VERSION 4
 
 namespace argparse {
     class Args;
+    class ParsedArgs;
+#ifdef HAS_MAGIC_ENUM
+    template <typename E> struct EnumTable;
+#endif
     using std::cout, std::cerr, std::endl, std::setw, std::size_t;
 
     template<typename T> struct is_vector : public std::false_type {};
@@ -67,6 +124,27 @@ namespace argparse {
     template<typename T> struct is_shared_ptr : public std::false_type {};
     template<typename T> struct is_shared_ptr<std::shared_ptr<T>> : public std::true_type {};
 
+    template<typename T> class lazy_list;
+    template<typename T> struct is_lazy_list : public std::false_type {};
+    template<typename T> struct is_lazy_list<lazy_list<T>> : public std::true_type {};
+
+    // Strings of other character types than char, which are transcoded from and to the UTF-8 of the commandline
+    template<typename T> struct is_unicode_string : public std::false_type {};
+    template<> struct is_unicode_string<std::wstring> : public std::true_type {};
+    template<> struct is_unicode_string<std::u16string> : public std::true_type {};
+    template<> struct is_unicode_string<std::u32string> : public std::true_type {};
+#ifdef __cpp_char8_t
+    template<> struct is_unicode_string<std::u8string> : public std::true_type {};
+#endif
+
+    template<typename T> class deferred;
+    template<typename T> struct is_deferred : public std::false_type {};
+    template<typename T> struct is_deferred<deferred<T>> : public std::true_type {};
+
+    // std::vector claims to be copy-assignable even when its elements are not
+    template<typename T> struct is_copy_assignable : public std::is_copy_assignable<T> {};
+    template<typename T, typename A> struct is_copy_assignable<std::vector<T, A>> : public is_copy_assignable<T> {};
+
     template <typename, typename = void> struct has_ostream_operator : std::false_type {};
     template <typename T> struct has_ostream_operator<T, decltype(void(std::declval<std::ostream&>() << std::declval<const T&>()))> : std::true_type {};
 
@@ -78,49 +156,700 @@ namespace argparse {
 #endif
     }
 
+    template <typename C> std::string utf8_encode(std::basic_string_view<C> v);
+
     template<typename T> std::string toString(const T &v) {
-        if constexpr (std::is_convertible<T, std::wstring>::value) {
-#if defined(__clang__)
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wdeprecated-declarations"
-#elif defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-#elif defined(_MSC_VER)
-#pragma warning(push)
-#pragma warning(disable : 4996) // C4996 is the typical MSVC deprecation warning
-#endif
-            return std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes(v);
-#if defined(__clang__)
-#pragma clang diagnostic pop
-#elif defined(__GNUC__)
-#pragma GCC diagnostic pop
-#elif defined(_MSC_VER)
-#pragma warning(pop)
+        if constexpr (std::is_same<T, std::filesystem::path>::value) {
+            if constexpr (std::is_same<std::filesystem::path::value_type, char>::value)
+                return v.native();
+            else
+                return utf8_encode(std::basic_string_view<std::filesystem::path::value_type>(v.native()));
+        } else if constexpr (std::is_convertible<T, std::wstring_view>::value) {
+            return utf8_encode(std::wstring_view(v));
+        } else if constexpr (std::is_convertible<T, std::u16string_view>::value) {
+            return utf8_encode(std::u16string_view(v));
+        } else if constexpr (std::is_convertible<T, std::u32string_view>::value) {
+            return utf8_encode(std::u32string_view(v));
+#ifdef __cpp_char8_t
+        } else if constexpr (std::is_convertible<T, std::u8string_view>::value) {
+            const std::u8string_view u8(v);
+            return std::string(u8.begin(), u8.end());
 #endif
 #ifdef HAS_MAGIC_ENUM
         } else if constexpr (std::is_enum<T>::value) {
-            for (const auto &[name, value] : magic_enum::enum_entries<T>()) {
-                if (v == name) {
-                    return std::string{ value };
-                }
-            }
+            const std::string_view name = EnumTable<T>::name(v);
+            if (!name.empty())
+                return std::string(name);
 #endif
+        } else if constexpr (is_vector<T>::value) {
+            std::string res;
+            for (size_t i = 0; i < v.size(); i++)
+                res += (i? "," : "") + toString(v[i]);
+            return res;
+        } else if constexpr (is_lazy_list<T>::value) {   // printed from the raw input, without converting
+            std::string res;
+            for (auto it = v.begin(); it != v.end(); ++it)
+                (res += (it == v.begin() ? "" : ",")) += it.raw();
+            return res;
+        } else if constexpr (is_optional<T>::value) {
+            return v.has_value() ? toString(*v) : "none";
+        } else if constexpr ((std::is_pointer<T>::value && !std::is_convertible<T, std::string_view>::value) || is_shared_ptr<T>::value) {
+            return v != nullptr ? toString(*v) : "none";
         } else if constexpr (has_ostream_operator<T>::value) {
             return static_cast<std::ostringstream &&>((std::ostringstream() << std::boolalpha << v)).str();       // https://github.com/stan-dev/math/issues/590#issuecomment-550122627
         }
         return "unknown";
     }
 
-    std::vector<std::string> inline split(const std::string &str) {
-        std::vector<std::string> splits;
-        std::stringstream ss(str);
-        std::string key;
-        while (std::getline(ss, key, ',')) {
-            if (!key.empty() && key.back() == '\0')
-                key.pop_back(); // last variables contain a '\0', which is unexpected when comparing to raw string, e.g. value == "test" will fail when the last character is '\0'. Therefore we can remove it
-            splits.emplace_back(std::move(key));
+    inline int count_trailing_zeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long idx;
+        _BitScanForward(&idx, mask);
+        return (int)idx;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // Bitmask of the positions in the next 16 (SSE2) or 32 (AVX2) bytes that are equal to `delim`
+#if defined(ARGPARSE_HAS_AVX2)
+    constexpr size_t simd_width = 32;
+    inline uint32_t match_mask(const char *p, char delim) {
+        return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), _mm256_set1_epi8(delim)));
+    }
+    inline uint32_t non_ascii_mask(const char *p) {     // the high bit of every byte
+        return (uint32_t)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)p));
+    }
+#elif defined(ARGPARSE_HAS_SSE2)
+    constexpr size_t simd_width = 16;
+    inline uint32_t match_mask(const char *p, char delim) {
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), _mm_set1_epi8(delim)));
+    }
+    inline uint32_t non_ascii_mask(const char *p) {
+        return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)p));
+    }
+#endif
+
+    // Number of occurrences of `delim` in `str`
+    inline size_t count_char(std::string_view str, char delim) {
+        const char *p = str.data(), *const end = p + str.size();
+        size_t count = 0;
+#if defined(ARGPARSE_HAS_SSE2)
+        for (; size_t(end - p) >= simd_width; p += simd_width)
+            count += std::bitset<32>(match_mask(p, delim)).count();
+#endif
+        return count + std::count(p, end, delim);
+    }
+
+    // Number of elements that `for_each_split` will produce for `str`
+    inline size_t count_split(std::string_view str, char delim=',') {
+        return str.empty() ? 0 : count_char(str, delim) + (str.back() == delim ? 0 : 1);
+    }
+
+    /* Call `f` with a view of every `delim`-separated element of `str`, without copying. Like std::getline, an empty trailing element is ignored, e.g. "1,2," yields "1" and "2".
+     * The delimiters are located 16 or 32 bytes at a time when SSE2 or AVX2 is available
+     */
+    template <typename F> void for_each_split(std::string_view str, F &&f, char delim=',') {
+        const char *start = str.data(), *p = str.data(), *const end = str.data() + str.size();
+#if defined(ARGPARSE_HAS_SSE2)
+        for (; size_t(end - p) >= simd_width; p += simd_width) {
+            for (uint32_t mask = match_mask(p, delim); mask != 0; mask &= mask - 1) {
+                const char *d = p + count_trailing_zeros(mask);
+                f(std::string_view(start, d - start));
+                start = d + 1;
+            }
+        }
+#endif
+        for (; p != end; ++p) {
+            if (*p == delim) {
+                f(std::string_view(start, p - start));
+                start = p + 1;
+            }
+        }
+        if (start != end)
+            f(std::string_view(start, end - start));
+    }
+
+    // Length of the run of ASCII characters at the start of `str`, which is scanned 16 or 32 bytes at a time when SSE2 or AVX2 is available
+    inline size_t ascii_prefix(std::string_view str) {
+        const char *p = str.data(), *const end = p + str.size();
+#if defined(ARGPARSE_HAS_SSE2)
+        for (; size_t(end - p) >= simd_width; p += simd_width) {
+            if (const uint32_t mask = non_ascii_mask(p))
+                return size_t(p - str.data()) + count_trailing_zeros(mask);
+        }
+#endif
+        while (p != end && (unsigned char)*p < 0x80)
+            ++p;
+        return size_t(p - str.data());
+    }
+
+    /* Decode UTF-8, where runs of ASCII are passed to `ascii` as views and every other code point to `code_point`.
+     * Returns false for invalid UTF-8: truncated or overlong sequences, surrogates and code points beyond U+10FFFF
+     */
+    template <typename A, typename F> bool decode_utf8(std::string_view v, A &&ascii, F &&code_point) {
+        size_t i = 0;
+        while (i < v.size()) {
+            const size_t n_ascii = ascii_prefix(v.substr(i));
+            if (n_ascii > 0) {
+                ascii(v.substr(i, n_ascii));
+                i += n_ascii;
+                if (i == v.size())
+                    break;
+            }
+
+            const unsigned char lead = (unsigned char)v[i];
+            size_t length;
+            char32_t c, min;
+            if ((lead & 0xE0) == 0xC0) {
+                length = 2, c = lead & 0x1F, min = 0x80;
+            } else if ((lead & 0xF0) == 0xE0) {
+                length = 3, c = lead & 0x0F, min = 0x800;
+            } else if ((lead & 0xF8) == 0xF0) {
+                length = 4, c = lead & 0x07, min = 0x10000;
+            } else {
+                return false;
+            }
+            if (v.size() - i < length)
+                return false;
+            for (size_t k = 1; k < length; k++) {
+                const unsigned char next = (unsigned char)v[i + k];
+                if ((next & 0xC0) != 0x80)
+                    return false;
+                c = (c << 6) | (next & 0x3F);
+            }
+            if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+                return false;
+            code_point(c);
+            i += length;
+        }
+        return true;
+    }
+
+    // Transcode UTF-8 into UTF-16 or UTF-32, depending on the size of C (e.g. wchar_t is UTF-16 on Windows and UTF-32 elsewhere)
+    template <typename C> bool utf8_decode(std::string_view v, std::basic_string<C> &out) {
+        out.clear();
+        out.reserve(v.size());  // never more code units than bytes
+        return decode_utf8(v, [&](std::string_view ascii) { out.append(ascii.begin(), ascii.end()); }, [&](char32_t c) {
+            if constexpr (sizeof(C) == 2) {
+                if (c >= 0x10000) {     // a surrogate pair
+                    c -= 0x10000;
+                    out += C(0xD800 + (c >> 10));
+                    c = 0xDC00 + (c & 0x3FF);
+                }
+            }
+            out += C(c);
+        });
+    }
+
+    inline bool is_valid_utf8(std::string_view v) {
+        return decode_utf8(v, [](std::string_view) {}, [](char32_t) {});
+    }
+
+    // Transcode UTF-16 or UTF-32 into UTF-8, where unpaired surrogates and invalid code points are replaced by U+FFFD
+    template <typename C> std::string utf8_encode(std::basic_string_view<C> v) {
+        std::string out;
+        out.reserve(v.size());
+        for (size_t i = 0; i < v.size(); i++) {
+            char32_t c = static_cast<char32_t>(static_cast<typename std::make_unsigned<C>::type>(v[i]));
+            if (c < 0x80) {
+                out += char(c);
+                continue;
+            }
+            if constexpr (sizeof(C) == 2) {
+                if (c >= 0xD800 && c <= 0xDBFF && i + 1 < v.size() && v[i + 1] >= 0xDC00 && v[i + 1] <= 0xDFFF)
+                    c = 0x10000 + ((c - 0xD800) << 10) + (static_cast<char32_t>(v[++i]) - 0xDC00);
+            }
+            if (c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+                c = 0xFFFD;
+            if (c < 0x800) {
+                out += char(0xC0 | (c >> 6));
+            } else if (c < 0x10000) {
+                out += char(0xE0 | (c >> 12));
+                out += char(0x80 | ((c >> 6) & 0x3F));
+            } else {
+                out += char(0xF0 | (c >> 18));
+                out += char(0x80 | ((c >> 12) & 0x3F));
+                out += char(0x80 | ((c >> 6) & 0x3F));
+            }
+            out += char(0x80 | (c & 0x3F));
+        }
+        return out;
+    }
+
+    /* A thread that reports whether it could be started, rather than throwing. Without exceptions it is started through pthreads, and on systems
+     * without pthreads it is never started at all, such that the caller does the work itself
+     */
+    class worker_thread {
+    public:
+        worker_thread() = default;
+        worker_thread(const worker_thread &) = delete;
+        worker_thread &operator=(const worker_thread &) = delete;
+        ~worker_thread() { join(); }
+
+        // Call `f()` on a new thread, where `f` must outlive the thread. Returns false when the thread could not be started
+        template <typename F> bool start(F &f) {
+#ifdef ARGPARSE_HAS_EXCEPTIONS
+            try {
+                thread_ = std::thread([&f] { f(); });
+                return true;
+            } catch (const std::system_error &) {   // e.g. when not linked with the threads library
+                return false;
+            }
+#elif defined(ARGPARSE_HAS_PTHREAD)
+            started_ = pthread_create(&handle_, nullptr, [](void *arg) -> void * { (*static_cast<F*>(arg))(); return nullptr; }, &f) == 0;
+            return started_;
+#else
+            (void)f;
+            return false;
+#endif
+        }
+
+        void join() {
+#ifdef ARGPARSE_HAS_EXCEPTIONS
+            if (thread_.joinable())
+                thread_.join();
+#elif defined(ARGPARSE_HAS_PTHREAD)
+            if (started_)
+                pthread_join(handle_, nullptr);
+            started_ = false;
+#endif
+        }
+
+    private:
+#ifdef ARGPARSE_HAS_EXCEPTIONS
+        std::thread thread_;
+#elif defined(ARGPARSE_HAS_PTHREAD)
+        pthread_t handle_{};
+        bool started_ = false;
+#endif
+    };
+
+    // Whether this thread is doing the work of a parallel_for, in which case nested calls run serially rather than starting threads of their own
+    inline thread_local bool in_parallel_for = false;
+
+    /* Call `f(i)` for every i in [0, n) on `n_threads` threads, using all cores when `n_threads` is 0. Every thread starts with an equal share of the range,
+     * and a thread that runs out of work steals the upper half of what remains of another thread. The first exception thrown by `f` is rethrown once all
+     * threads are done. Runs serially when called from within another parallel_for, and the work of threads that could not be started is stolen by the others.
+     * Using this requires linking with the threads library (e.g. Threads::Threads in CMake)
+     */
+    template <typename F> void parallel_for(size_t n, F &&f, size_t n_threads=0) {
+        if (n_threads == 0)
+            n_threads = std::max(1u, std::thread::hardware_concurrency());
+        n_threads = std::min(n_threads, n);
+        if (n_threads <= 1 || in_parallel_for) {
+            for (size_t i = 0; i < n; i++)
+                f(i);
+            return;
+        }
+
+        struct alignas(64) Range {  // the remaining work of one thread, on its own cache line
+            std::mutex mutex;
+            size_t begin = 0;
+            size_t end = 0;
+        };
+        std::vector<Range> ranges(n_threads);
+        for (size_t t = 0; t < n_threads; t++) {
+            ranges[t].begin = n * t / n_threads;
+            ranges[t].end = n * (t + 1) / n_threads;
+        }
+        std::exception_ptr error;
+        std::mutex error_mutex;
+
+        auto worker = [&](size_t t) {
+            in_parallel_for = true;
+            Range &own = ranges[t];
+            while (true) {
+                size_t i = n;
+                {
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    if (own.begin < own.end)
+                        i = own.begin++;
+                }
+                if (i == n) {   // out of work, steal from the next thread that has some left. Only one lock is held at a time, so threads can not deadlock
+                    size_t begin = 0, end = 0;
+                    for (size_t k = 1; k < n_threads && begin == end; k++) {
+                        Range &victim = ranges[(t + k) % n_threads];
+                        std::lock_guard<std::mutex> lock(victim.mutex);
+                        end = victim.end;
+                        begin = victim.end - (victim.end - victim.begin + 1) / 2;
+                        victim.end = begin;
+                    }
+                    if (begin == end)
+                        return;
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    own.begin = begin;
+                    own.end = end;
+                    continue;
+                }
+#ifdef ARGPARSE_HAS_EXCEPTIONS
+                try {
+                    f(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (error == nullptr)
+                        error = std::current_exception();
+                }
+#else
+                f(i);
+#endif
+            }
+        };
+
+        struct Task {   // the work of one of the started threads, which stays at the same address while the thread runs
+            decltype(worker) *run = nullptr;
+            size_t t = 0;
+            void operator()() const { (*run)(t); }
+        };
+        std::vector<Task> tasks(n_threads);
+        std::unique_ptr<worker_thread[]> threads(new worker_thread[n_threads]);
+        for (size_t t = 1; t < n_threads; t++) {
+            tasks[t] = Task{&worker, t};
+            if (!threads[t].start(tasks[t]))    // the work of the threads that are missing is stolen by the others
+                break;
+        }
+        worker(0);
+        in_parallel_for = false;    // this thread was not doing the work of a parallel_for before
+        for (size_t t = 1; t < n_threads; t++)
+            threads[t].join();
+#ifdef ARGPARSE_HAS_EXCEPTIONS
+        if (error != nullptr)
+            std::rethrow_exception(error);
+#endif
+    }
+
+    // Vectors with at least this many elements are converted on multiple threads, set to SIZE_MAX to always convert on a single thread
+    inline std::atomic<size_t> parallel_threshold{1 << 16};
+
+    /* A read-only, memory-mapped view of a file. The mapping is released when the mapped_file is destroyed.
+     * On systems without mmap the file is read into memory instead.
+     * As the type of an argument, the file named on the commandline is mapped while parsing, where a file that can not be opened is reported as an invalid argument
+     */
+    class mapped_file {
+        const char *data_ = nullptr;
+        size_t size_ = 0;
+        std::string path_;
+#ifndef ARGPARSE_HAS_MMAP
+        std::unique_ptr<char[]> buffer_;
+#endif
+
+    public:
+        // How the mapping will be accessed, see `advise`
+        enum class advice { normal, sequential, random, willneed };
+
+        mapped_file() = default;
+        explicit mapped_file(std::string_view path) {
+            if (!open(path))
+                ARGPARSE_THROW(std::runtime_error("could not open file: " + std::generic_category().message(errno)));
+        }
+        mapped_file(const mapped_file &) = delete;
+        mapped_file &operator=(const mapped_file &) = delete;
+        mapped_file(mapped_file &&other) noexcept { *this = std::move(other); }
+        mapped_file &operator=(mapped_file &&other) noexcept {
+            if (this != &other) {
+                close();
+                std::swap(data_, other.data_);
+                std::swap(size_, other.size_);
+                std::swap(path_, other.path_);
+#ifndef ARGPARSE_HAS_MMAP
+                std::swap(buffer_, other.buffer_);
+#endif
+            }
+            return *this;
+        }
+        ~mapped_file() { close(); }
+
+        // Map the regular file at `path`, returns false when it can not be opened, with the reason in errno
+        bool open(std::string_view path) {
+            close();
+            const std::string path_str(path);
+#ifdef ARGPARSE_HAS_MMAP
+            const int fd = ::open(path_str.c_str(), O_RDONLY);
+            if (fd < 0)
+                return false;
+            struct stat st{};
+            bool success = ::fstat(fd, &st) == 0;
+            int error = errno;
+            if (success && !S_ISREG(st.st_mode)) {
+                success = false;
+                error = S_ISDIR(st.st_mode) ? EISDIR : EINVAL;
+            }
+            if (success && st.st_size > 0) {
+                void *p = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                success = p != MAP_FAILED;
+                error = errno;
+                if (success) {
+                    data_ = (const char *)p;
+                    size_ = (size_t)st.st_size;
+                }
+            }
+            ::close(fd);
+            if (!success)
+                errno = error;  // not overwritten by close
+            else
+                path_ = path_str;
+            return success;
+#else
+            std::ifstream file(path_str, std::ios::binary | std::ios::ate);
+            if (!file.is_open() || std::filesystem::is_directory(path_str)) {
+                errno = file.is_open() ? EISDIR : ENOENT;
+                return false;
+            }
+            path_ = path_str;
+            size_ = (size_t)file.tellg();
+            buffer_ = std::make_unique<char[]>(size_ + 1);
+            file.seekg(0);
+            file.read(buffer_.get(), (std::streamsize)size_);
+            data_ = buffer_.get();
+            return true;
+#endif
+        }
+
+        void close() {
+#ifdef ARGPARSE_HAS_MMAP
+            if (data_ != nullptr)
+                ::munmap((void *)data_, size_);
+#else
+            buffer_.reset();
+#endif
+            data_ = nullptr;
+            size_ = 0;
+            path_.clear();
+        }
+
+        // Hint the kernel how the mapping will be accessed, e.g. to read ahead more aggressively for `sequential`. Has no effect when the file is read into memory
+        void advise(advice hint) const {
+#ifdef ARGPARSE_HAS_MMAP
+            static constexpr int flags[] = {MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED};
+            if (data_ != nullptr)
+                (void)::madvise((void *)data_, size_, flags[(int)hint]);
+#else
+            (void)hint;
+#endif
+        }
+
+        [[nodiscard]] const char *data() const { return data_; }
+        [[nodiscard]] size_t size() const { return size_; }
+        [[nodiscard]] std::string_view view() const { return {data_, size_}; }
+        [[nodiscard]] bool is_open() const { return !path_.empty(); }
+        [[nodiscard]] const std::string &path() const { return path_; }
+
+        // Printed as its path, e.g. in the help
+        friend std::ostream &operator<<(std::ostream &os, const mapped_file &file) { return os << file.path_; }
+    };
+
+    inline bool is_little_endian() {
+        const uint16_t one = 1;
+        unsigned char first;
+        std::memcpy(&first, &one, 1);
+        return first == 1;
+    }
+
+    template <typename T> T swap_bytes(T v) {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &v, sizeof(T));
+        std::reverse(bytes, bytes + sizeof(T));
+        std::memcpy(&v, bytes, sizeof(T));
+        return v;
+    }
+
+    // Where the numbers of type T are stored within a .npy file (https://numpy.org/devdocs/reference/generated/numpy.lib.format.html) or a raw binary file
+    struct ArrayLayout {
+        size_t offset = 0;          // start of the data within the file
+        size_t count = 0;           // number of elements
+        std::vector<size_t> shape;
+        bool swapped = false;       // stored in the opposite byte order of this system
+    };
+
+    // The value of `key` in the python dict literal of a .npy header, up to the end of the header. Empty when the key is missing
+    inline std::optional<std::string_view> npy_field(std::string_view header, std::string_view key) {
+        const size_t pos = header.find("'" + std::string(key) + "'");
+        if (pos == std::string_view::npos)
+            return std::nullopt;
+        size_t i = header.find(':', pos);
+        if (i == std::string_view::npos)
+            return std::nullopt;
+        while (++i < header.size() && header[i] == ' ') {}
+        return header.substr(i);
+    }
+
+    /* Read the layout of a file of numbers of type T. A .npy file (recognised by its magic string) must hold C-ordered elements of exactly
+     * the type T, in either byte order. Any other file is taken as the raw elements in the byte order of this system. Returns the reason
+     * when the file can not be read as such, or an empty string
+     */
+    template <typename T> std::string read_array_layout(std::string_view content, ArrayLayout &layout) {
+        if (content.substr(0, 6) != "\x93NUMPY") {
+            if (content.size() % sizeof(T) != 0)
+                return "size of " + std::to_string(content.size()) + " bytes is not a multiple of the element size of " + std::to_string(sizeof(T)) + " bytes";
+            layout.count = content.size() / sizeof(T);
+            layout.shape = {layout.count};
+            return {};
+        }
+
+        const size_t len_size = content.size() > 6 && content[6] == 1 ? 2 : 4;  // the length of the header is a uint16 in version 1, a uint32 since version 2
+        if (content.size() < 8 + len_size)
+            return "invalid .npy file, truncated header";
+        size_t header_len = 0;
+        for (size_t i = 0; i < len_size; i++)
+            header_len |= size_t((unsigned char)content[8 + i]) << (8 * i);
+        layout.offset = 8 + len_size + header_len;
+        if (layout.offset > content.size())
+            return "invalid .npy file, truncated header";
+        const std::string_view header = content.substr(8 + len_size, header_len);
+
+        const std::optional<std::string_view> descr = npy_field(header, "descr");
+        if (!descr)
+            return "invalid .npy header, missing 'descr'";
+        const char kind = std::is_floating_point<T>::value ? 'f' : std::is_signed<T>::value ? 'i' : 'u';
+        const std::string expected = std::string(sizeof(T) == 1 ? "|" : is_little_endian() ? "<" : ">") + kind + std::to_string(sizeof(T));
+        const size_t descr_end = descr->find(descr->empty() ? '\'' : (*descr)[0], 1);
+        const std::string_view dtype = descr->substr(std::min<size_t>(1, descr->size()), descr_end == std::string_view::npos ? 0 : descr_end - 1);
+        if (dtype.size() < 3 || dtype[1] != kind || dtype.substr(2) != expected.substr(2) || (dtype[0] != '<' && dtype[0] != '>' && dtype[0] != '|' && dtype[0] != '='))
+            return "dtype '" + std::string(dtype) + "' of the .npy file does not match '" + expected + "'";
+        layout.swapped = sizeof(T) > 1 && (dtype[0] == '<' || dtype[0] == '>') && (dtype[0] == '<') != is_little_endian();
+
+        std::optional<std::string_view> shape = npy_field(header, "shape");
+        if (!shape)
+            return "invalid .npy header, missing 'shape'";
+        *shape = shape->substr(0, shape->find(')'));
+        bool malformed = false, overflow = false;
+        layout.count = 1;
+        for_each_split(shape->substr(std::min<size_t>(1, shape->size())), [&](std::string_view dim) {
+            while (!dim.empty() && dim[0] == ' ')
+                dim.remove_prefix(1);
+            if (dim.empty())    // the trailing comma of a 1-dimensional tuple, e.g. (3,)
+                return;
+            size_t n = 0;
+            const auto [ptr, ec] = std::from_chars(dim.data(), dim.data() + dim.size(), n);
+            malformed |= ec != std::errc() || ptr != dim.data() + dim.size();
+            overflow |= n != 0 && layout.count > SIZE_MAX / n;
+            layout.shape.push_back(n);
+            layout.count *= n;
+        });
+        if (malformed)
+            return "invalid .npy header, malformed shape";
+        if (overflow)
+            return "invalid .npy header, the number of elements of its shape overflows";
+        if (layout.shape.size() > 1) {
+            const std::optional<std::string_view> fortran_order = npy_field(header, "fortran_order");
+            if (!fortran_order)
+                return "invalid .npy header, missing 'fortran_order'";
+            if (fortran_order->substr(0, 4) == "True")
+                return "the .npy file is stored in Fortran order, only C order is supported";
+        }
+        if ((content.size() - layout.offset) / sizeof(T) < layout.count)
+            return "the .npy file holds fewer elements than its shape";
+        return {};
+    }
+
+    // Copy the numbers in the .npy or raw binary file at `path` into `out`, without parsing any text. Returns the reason when it fails, or an empty string
+    template <typename V> std::string load_array(std::string_view path, V &out) {
+        using E = typename V::value_type;
+        mapped_file file;
+        if (!file.open(path))
+            return "could not open file: " + std::generic_category().message(errno);
+        ArrayLayout layout;
+        std::string error = read_array_layout<E>(file.view(), layout);
+        if (!error.empty())
+            return error;
+        out.resize(layout.count);
+        if (layout.count > 0)
+            std::memcpy(out.data(), file.data() + layout.offset, layout.count * sizeof(E));
+        if (layout.swapped) {
+            for (E &e : out)
+                e = swap_bytes(e);
+        }
+        return {};
+    }
+
+    /* A read-only view of the numbers in a .npy or raw binary file, which are used in place within the memory-mapped file instead of being copied.
+     * Unlike a vector, the elements must be stored in the byte order of this system. Copies share the same mapping
+     */
+    template <typename T> class mapped_span {
+        std::shared_ptr<const mapped_file> file_;
+        const T *data_ = nullptr;
+        size_t size_ = 0;
+        std::vector<size_t> shape_;
+
+    public:
+        using value_type = T;
+
+        mapped_span() = default;
+        explicit mapped_span(std::string_view path) {
+            const std::string error = open(path);
+            if (!error.empty())
+                ARGPARSE_THROW(std::runtime_error(error));
+        }
+
+        /* Map the file at `path`, which may be prefixed with "@@" like a vector that is loaded from a file. An empty path gives an empty span.
+         * Returns the reason when it fails, or an empty string
+         */
+        std::string open(std::string_view path) {
+            *this = mapped_span();
+            if (path.size() > 2 && path.substr(0, 2) == "@@")
+                path.remove_prefix(2);
+            if (path.empty())
+                return {};
+            auto file = std::make_shared<mapped_file>();
+            if (!file->open(path))
+                return "could not open file: " + std::generic_category().message(errno);
+            ArrayLayout layout;
+            std::string error = read_array_layout<T>(file->view(), layout);
+            if (!error.empty())
+                return error;
+            const char *data = file->data() + layout.offset;
+            if (layout.swapped)
+                return "the .npy file is not stored in the byte order of this system, which can only be loaded into a vector";
+            if (reinterpret_cast<uintptr_t>(data) % alignof(T) != 0)
+                return "the data in the file is not aligned to " + std::to_string(alignof(T)) + " bytes";
+            file_ = std::move(file);
+            data_ = reinterpret_cast<const T *>(data);
+            size_ = layout.count;
+            shape_ = std::move(layout.shape);
+            return {};
+        }
+
+        [[nodiscard]] const T *data() const { return data_; }
+        [[nodiscard]] size_t size() const { return size_; }
+        [[nodiscard]] bool empty() const { return size_ == 0; }
+        [[nodiscard]] const std::vector<size_t> &shape() const { return shape_; }
+        [[nodiscard]] const T *begin() const { return data_; }
+        [[nodiscard]] const T *end() const { return data_ + size_; }
+        [[nodiscard]] const T &operator[](size_t i) const { return data_[i]; }
+
+        // Printed as the path of the file, e.g. in the help
+        friend std::ostream &operator<<(std::ostream &os, const mapped_span &span) { return os << (span.file_ != nullptr ? "@@" + span.file_->path() : ""); }
+    };
+
+    template<typename T> struct is_mapped_span : public std::false_type {};
+    template<typename T> struct is_mapped_span<mapped_span<T>> : public std::true_type {};
+
+    /* Call `f` with a view of every argument in the contents of a response file, one at a time while scanning.
+     * Arguments are separated by whitespace, and may be wrapped in single or double quotes to include whitespace (e.g. "my file.txt")
+     */
+    template <typename F> void for_each_response_token(std::string_view content, F &&f) {
+        size_t i = 0;
+        while (true) {
+            while (i < content.size() && std::isspace((unsigned char)content[i]))
+                i++;
+            if (i == content.size())
+                return;
+            if (content[i] == '"' || content[i] == '\'') {
+                const size_t end = std::min(content.find(content[i], i + 1), content.size());
+                f(content.substr(i + 1, end - i - 1));
+                i = std::min(end + 1, content.size());
+            } else {
+                const size_t start = i;
+                while (i < content.size() && !std::isspace((unsigned char)content[i]))
+                    i++;
+                f(content.substr(start, i - start));
+            }
         }
+    }
+
+    std::vector<std::string> inline split(std::string_view str) {
+        std::vector<std::string> splits;
+        for_each_split(str, [&](std::string_view s) { splits.emplace_back(s); });
         return splits;
     }
 
@@ -130,236 +859,1926 @@ namespace argparse {
         return str;
     }
 
-    template<typename T> inline T get(const std::string &v);
-    template<> inline std::string get(const std::string &v) { return v; }
-    template<> inline std::wstring get(const std::string &v) { return std::wstring(v.begin(), v.end()); }
-    template<> inline char get(const std::string &v) { return v.empty()? throw std::invalid_argument("empty string") : v.size() > 1?  v.substr(0,2) == "0x"? (char)std::stoul(v, nullptr, 16) : (char)std::stoi(v) : v[0]; }
-    template<> inline int get(const std::string &v) { return std::stoi(v); }
-    template<> inline short get(const std::string &v) { return std::stoi(v); }
-    template<> inline long get(const std::string &v) { return std::stol(v); }
-    template<> inline long long get(const std::string &v) { return std::stol(v); }
-    template<> inline bool get(const std::string &v) { return to_lower(v) == "true" || v == "1"; }
-    template<> inline float get(const std::string &v) { return std::stof(v); }
-    template<> inline double get(const std::string &v) { return std::stod(v); }
-    template<> inline unsigned char get(const std::string &v) { return get<char>(v); }
-    template<> inline unsigned int get(const std::string &v) { return std::stoul(v); }
-    template<> inline unsigned short get(const std::string &v) { return std::stoul(v); }
-    template<> inline unsigned long get(const std::string &v) { return std::stoul(v); }
-    template<> inline unsigned long long get(const std::string &v) { return std::stoul(v); }
-
-    template<typename T> inline T get(const std::string &v) { // remaining types
-        if constexpr (is_vector<T>::value) {
-            const std::vector<std::string> splitted = split(v);
-            T res(splitted.size());
-            if (!v.empty())
-                std::transform (splitted.begin(), splitted.end(), res.begin(), get<typename T::value_type>);
-            return res;
-        } else if constexpr (std::is_pointer<T>::value) {
-            return new typename std::remove_pointer<T>::type(get<typename std::remove_pointer<T>::type>(v));
-        } else if constexpr (is_shared_ptr<T>::value) {
-            return std::make_shared<typename T::element_type>(get<typename T::element_type>(v));
-        } else if constexpr (is_optional<T>::value) {
-            return get<typename T::value_type>(v);
-        } else if constexpr (std::is_enum<T>::value) {  // case-insensitive enum conversion
-#ifdef HAS_MAGIC_ENUM
-            constexpr auto& enum_entries = magic_enum::enum_entries<T>();
-            const std::string lower_str = to_lower(v);
-            for (const auto &[value, name] : enum_entries) {
-                if (to_lower(name) == lower_str)
-                    return value;
-            }
-            std::string error = "enum is only accepting [";
-            for (size_t i = 0; i < enum_entries.size(); i++)
-                error += (i==0? "" : ", ") + to_lower(enum_entries[i].second);
-            error += "]";
-            throw std::runtime_error(error);
-#else
-            throw std::runtime_error("Enum not supported, please install magic_enum (https://github.com/Neargye/magic_enum)");
-#endif
-        } else {
-            return T(v);
-        }
+    // ASCII lowercase, which unlike std::tolower does not depend on the locale and can be used at compile time
+    constexpr char fold_case(char c) {
+        return c >= 'A' && c <= 'Z' ? char(c - 'A' + 'a') : c;
     }
 
-    struct ConvertBase {
-        virtual ~ConvertBase() = default;
-        virtual void convert(const std::string &v) = 0;
-        virtual void set_default(const std::unique_ptr<ConvertBase> &default_value, const std::string &default_string) = 0;
-        [[nodiscard]] virtual size_t get_type_id() const = 0;
-        [[nodiscard]] virtual std::string get_allowed_entries() const = 0;
-    };
+    inline bool iequals(std::string_view a, std::string_view b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) { return fold_case(x) == fold_case(y); });
+    }
+
+    constexpr uint64_t hash_key(std::string_view key) { // FNV-1a
+        uint64_t h = 14695981039346656037ull;
+        for (const char c : key)
+            h = (h ^ (unsigned char)c) * 1099511628211ull;
+        return h;
+    }
 
-    template <typename T> struct ConvertType : public ConvertBase {
-        T data;
-        ~ConvertType() override = default;
-        ConvertType() : ConvertBase() {};
-        explicit ConvertType(const T &value) : ConvertBase(), data(value) {};
+    // Case-insensitive counterpart of hash_key, such that keys that are equal according to `iequals` have the same hash
+    constexpr uint64_t hash_key_folded(std::string_view key) {
+        uint64_t h = 14695981039346656037ull;
+        for (const char c : key)
+            h = (h ^ (unsigned char)fold_case(c)) * 1099511628211ull;
+        return h;
+    }
 
-        void convert(const std::string &v) override {
-            data = get<T>(v);
+    // Open-addressing hash table from case-folded name to index + 1, where 0 marks an empty slot. Names that fold to the same key keep the first
+    template <size_t Capacity, size_t N> constexpr std::array<uint32_t, Capacity> make_enum_name_slots(const std::array<std::string_view, N> &names) {
+        std::array<uint32_t, Capacity> slots{};
+        for (size_t i = 0; i < N; i++) {
+            size_t s = hash_key_folded(names[i]) & (Capacity - 1);
+            while (slots[s] != 0)
+                s = (s + 1) & (Capacity - 1);
+            slots[s] = uint32_t(i + 1);
         }
+        return slots;
+    }
 
-        void set_default(const std::unique_ptr<ConvertBase> &default_value, const std::string &default_string) override {
-            if (this->get_type_id() == default_value->get_type_id())    // When the types do not match exactly. resort to string conversion
-                data = ((ConvertType<T>*)(default_value.get()))->data;
-            else
-                data = get<T>(default_string);
+    // Table from value - values[0] to index + 1, where 0 marks a value that is not part of the enum
+    template <size_t Range, typename E, size_t N> constexpr std::array<uint32_t, Range> make_enum_value_slots(const std::array<E, N> &values) {
+        std::array<uint32_t, Range> slots{};
+        for (size_t i = 0; i < N && Range > 0; i++)
+            slots[size_t((long long)values[i] - (long long)values[0])] = uint32_t(i + 1);
+        return slots;
+    }
+
+    /* Lookup tables of an enum, computed at compile time from the `names` and `values` (in increasing order) of its `Reflection`: a hash table from
+     * case-insensitive name to value, and a table from value to name. Both take constant time and never allocate. Values that are spread too sparsely
+     * for a table (e.g. flags) are found by binary search instead
+     */
+    template <typename E, typename Reflection> struct BasicEnumTable {
+        static constexpr auto names = Reflection::names;
+        static constexpr auto values = Reflection::values;
+        static constexpr size_t n = values.size();
+
+        static constexpr size_t capacity() {    // a power of two, which is at most half full
+            size_t c = 1;
+            while (c < 2 * n)
+                c *= 2;
+            return c;
+        }
+        static constexpr size_t range = n > 0 ? size_t((long long)values[n - 1] - (long long)values[0] + 1) : 0;
+        static constexpr bool dense = range <= 4 * n + 64;
+
+        static constexpr std::array<uint32_t, capacity()> name_slots = make_enum_name_slots<capacity()>(names);
+        static constexpr std::array<uint32_t, dense ? range : 0> value_slots = make_enum_value_slots<dense ? range : 0>(values);
+
+        // Find the value with a case-insensitive `name`
+        static bool find(std::string_view name, E &out) {
+            for (size_t s = hash_key_folded(name) & (capacity() - 1); name_slots[s] != 0; s = (s + 1) & (capacity() - 1)) {
+                if (iequals(names[name_slots[s] - 1], name)) {
+                    out = values[name_slots[s] - 1];
+                    return true;
+                }
+            }
+            return false;
         }
 
-        [[nodiscard]] size_t get_type_id() const override {
-            return typeid(T).hash_code();
+        // The name of `value`, or an empty view if it is not part of the enum
+        static std::string_view name(E value) {
+            if constexpr (n == 0) {     // an enum without enumerators, of which there is no first value to offset from
+                (void)value;
+            } else if constexpr (dense) {
+                const long long offset = (long long)value - (long long)values[0];
+                if (offset >= 0 && offset < (long long)range && value_slots[offset] != 0)
+                    return names[value_slots[offset] - 1];
+            } else {
+                const auto it = std::lower_bound(values.begin(), values.end(), value);
+                if (it != values.end() && *it == value)
+                    return names[it - values.begin()];
+            }
+            return {};
         }
+    };
 
-        [[nodiscard]] std::string get_allowed_entries() const override {
-            std::stringstream ss;
+#ifdef HAS_MAGIC_ENUM
+    template <typename E> struct MagicEnumReflection {
+        static constexpr auto names = magic_enum::enum_names<E>();
+        static constexpr auto values = magic_enum::enum_values<E>();
+    };
+
+    // The lookup tables of an enum as reflected by magic_enum
+    template <typename E> struct EnumTable : BasicEnumTable<E, MagicEnumReflection<E>> {};
+#endif
+
+    /* Convert a number without exceptions, allocations or locale, using std::from_chars.
+     * Integers accept an optional sign and a 0x (hexadecimal), 0o (octal) or 0b (binary) prefix, and are range-checked for the exact type T.
+     * Floating point values accept an optional sign, a 0x prefix for hexadecimal floats and a trailing f/F as in C++ literals (e.g. "0.5f").
+     * Returns std::errc() on success, std::errc::invalid_argument when `v` is not a number and std::errc::result_out_of_range when it does not fit in T.
+     */
+    template <typename T> std::errc parse_number(std::string_view v, T &out) {
+        static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, "parse_number only supports integer and floating point types");
+        bool negative = false;
+        if (!v.empty() && (v[0] == '+' || v[0] == '-')) {
+            negative = v[0] == '-';
+            v.remove_prefix(1);
+        }
+        const bool is_hex = v.size() > 2 && v[0] == '0' && (v[1] == 'x' || v[1] == 'X');
+
+        if constexpr (std::is_floating_point<T>::value) {
+            if (v.size() > 1 && (v.back() == 'f' || v.back() == 'F') && !is_hex && (std::isdigit((unsigned char)v[v.size() - 2]) || v[v.size() - 2] == '.'))
+                v.remove_suffix(1);
+            if (is_hex)
+                v.remove_prefix(2);
+            if (v.empty() || v[0] == '+' || v[0] == '-')
+                return std::errc::invalid_argument;
+            T value;
+#if defined(__cpp_lib_to_chars)
+            const auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), value, is_hex ? std::chars_format::hex : std::chars_format::general);
+            if (ec != std::errc())
+                return ec;
+            if (ptr != v.data() + v.size())
+                return std::errc::invalid_argument;
+#else       // Standard libraries without floating point from_chars, fall back to strtold on a null-terminated copy
+            if (v.size() > 255 || std::isspace((unsigned char)v[0]))
+                return std::errc::invalid_argument;
+            char buffer[260] = "0x";
+            std::copy(v.begin(), v.end(), buffer + 2);
+            char *const begin = is_hex ? buffer : buffer + 2, *end = nullptr;
+            errno = 0;
+            const long double parsed = std::strtold(begin, &end);
+            if (end != buffer + 2 + v.size())
+                return std::errc::invalid_argument;
+            if (errno == ERANGE || (!std::isinf(parsed) && parsed > std::numeric_limits<T>::max()))
+                return std::errc::result_out_of_range;
+            value = static_cast<T>(parsed);
+#endif
+            out = negative ? -value : value;
+        } else {
+            int base = 10;
+            if (v.size() > 2 && v[0] == '0') {
+                switch (v[1]) {
+                    case 'x': case 'X': base = 16; break;
+                    case 'o': case 'O': base = 8; break;
+                    case 'b': case 'B': base = 2; break;
+                    default: break;
+                }
+                if (base != 10)
+                    v.remove_prefix(2);
+            }
+            unsigned long long magnitude = 0;
+            const auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), magnitude, base);   // parsing as unsigned rejects any further sign
+            if (ec != std::errc())
+                return ec;
+            if (ptr != v.data() + v.size())
+                return std::errc::invalid_argument;
+
+            using U = typename std::make_unsigned<T>::type;
+            if constexpr (std::is_signed<T>::value) {
+                const unsigned long long limit = (unsigned long long)(U)std::numeric_limits<T>::max() + (negative ? 1 : 0);
+                if (magnitude > limit)
+                    return std::errc::result_out_of_range;
+                out = negative && magnitude != 0 ? static_cast<T>(-static_cast<T>(magnitude - 1) - 1) : static_cast<T>(magnitude);
+            } else {
+                if (magnitude > std::numeric_limits<T>::max() || (negative && magnitude != 0))
+                    return std::errc::result_out_of_range;
+                out = static_cast<T>(magnitude);
+            }
+        }
+        return std::errc();
+    }
+
+    // Reason why a value could not be converted, or why an argument is invalid, see `ParseError`
+    enum class ErrorCode {
+        NONE,
+        INVALID_VALUE,          // the value could not be converted, e.g. "abc" for a number
+        OUT_OF_RANGE,           // the value does not fit in the type
+        NOT_ALLOWED,            // the value is not one of the allowed values of an enum
+        CUSTOM,                 // a custom type threw an exception while converting
+        MISSING_VALUE,          // a keyworded argument that takes a value was given without one
+        MISSING_ARGUMENT,       // a required argument was not provided
+        UNRECOGNISED_ARGUMENT,  // an unknown key was provided
+        NESTED_RESPONSE_FILE,   // response files are nested too deeply
+    };
 
+    // The allowed values of an enum (or a container of enums), separated by ", ". Empty for other types, or when magic_enum is not available
+    template <typename T> std::string allowed_values() {
+        if constexpr (is_vector<T>::value || is_optional<T>::value || is_lazy_list<T>::value) {
+            return allowed_values<typename T::value_type>();
+        } else if constexpr (std::is_pointer<T>::value) {
+            return allowed_values<typename std::remove_pointer<T>::type>();
+        } else if constexpr (is_shared_ptr<T>::value) {
+            return allowed_values<typename T::element_type>();
+        } else {
+            std::string res;
 #ifdef HAS_MAGIC_ENUM
             if constexpr (std::is_enum<T>::value) {
-                for (const auto &[value, name] : magic_enum::enum_entries<T>()) {
-                    ss << to_lower(name) << ", ";
-                }
+                for (const auto &[value, name] : magic_enum::enum_entries<T>())
+                    res += (res.empty() ? "" : ", ") + to_lower(name);
             }
 #endif
+            return res;
+        }
+    }
 
-            return ss.str();
+    inline std::string not_allowed_message(const std::string &allowed) {
+        if (allowed.empty())
+            return "Enum not supported, please install magic_enum (https://github.com/Neargye/magic_enum)";
+        return "enum is only accepting [" + allowed + "]";
+    }
+
+    template<typename T> inline T get(std::string_view v);
+    template<typename T> inline ErrorCode try_convert(std::string_view v, T &out, std::string *detail=nullptr);
+
+    inline ErrorCode to_error_code(std::errc ec) {
+        if (ec == std::errc())
+            return ErrorCode::NONE;
+        return ec == std::errc::result_out_of_range ? ErrorCode::OUT_OF_RANGE : ErrorCode::INVALID_VALUE;
+    }
+
+    // Report an ErrorCode::CUSTOM of a built-in conversion, which does not throw, with its message (e.g. why a file could not be opened) in `detail` when given
+    inline ErrorCode custom_error(std::string *detail, std::string message) {
+        if (detail != nullptr)
+            *detail = std::move(message);
+        return ErrorCode::CUSTOM;
+    }
+
+    // Convert and append an element to a container, without an intermediate copy when the element can be converted in place
+    template <typename V> ErrorCode try_emplace_back(V &out, std::string_view v, std::string *detail=nullptr) {
+        using E = typename V::value_type;
+        if constexpr (std::is_default_constructible<E>::value && !std::is_same<E, bool>::value) {  // std::vector<bool> has no references to its elements
+            out.emplace_back();
+            const ErrorCode code = try_convert(v, out.back(), detail);
+            if (code != ErrorCode::NONE)
+                out.pop_back();
+            return code;
+        } else {
+            out.emplace_back(get<E>(v));
+            return ErrorCode::NONE;
         }
+    }
+
+    // Elements that can be converted concurrently into a pre-sized vector, without allocating from a memory resource that may not be thread-safe
+    template <typename E> constexpr bool is_parallel_convertible() {
+        return (std::is_arithmetic<E>::value && !std::is_same<E, bool>::value) || std::is_enum<E>::value || std::is_same<E, std::string>::value;
+    }
+
+    // The first element that failed to convert within a chunk of a vector
+    struct ChunkError {
+        size_t index = SIZE_MAX;
+        ErrorCode code = ErrorCode::NONE;
+        std::string_view value;
     };
 
-    struct Entry {
-        enum ARG_TYPE {ARG, KWARG, FLAG} type;
+    inline ChunkError first_error(const std::vector<ChunkError> &errors) {
+        ChunkError first;
+        for (const ChunkError &error : errors) {
+            if (error.index < first.index)
+                first = error;
+        }
+        return first;
+    }
 
-        Entry(ARG_TYPE type, const std::string& key, std::string help, std::optional<std::string> implicit_value=std::nullopt) :
-                type(type),
-                keys_(split(key)),
-                help(std::move(help)),
-                implicit_value_(std::move(implicit_value)) {
+    /* Convert the `delim`-separated elements of `v` into the vector `out`, where `failed` is set to the first element that fails to convert,
+     * and `detail` (when given) to the message of an ErrorCode::CUSTOM. Lists of at least `parallel_threshold` elements are cut into chunks at delimiters, which are counted and converted on all cores straight into their
+     * place in `out`. The error is that of the first failing element, regardless of the order in which the chunks are converted
+     */
+    template <typename V> ErrorCode try_convert_split(std::string_view v, V &out, std::string_view &failed, char delim=',', std::string *detail=nullptr) {
+        using E = typename V::value_type;
+        if constexpr (std::is_arithmetic<E>::value && !std::is_same<E, bool>::value) {
+            if (v.size() > 2 && v.substr(0, 2) == "@@") {     // the numbers in a .npy or raw binary file
+                std::string error = load_array(v.substr(2), out);
+                return error.empty() ? ErrorCode::NONE : custom_error(detail, std::move(error));
+            }
+        }
+        const size_t n = count_split(v, delim);
+        if constexpr (is_parallel_convertible<E>()) {
+            if (n >= parallel_threshold && n > 1) {
+                const size_t n_chunks = std::min<size_t>(n / 1024 + 1, 64 * std::max(1u, std::thread::hardware_concurrency()));
+                std::vector<size_t> bounds(n_chunks + 1, v.size());   // every chunk but the first starts right after a delimiter
+                bounds[0] = 0;
+                for (size_t k = 1; k < n_chunks; k++) {
+                    const size_t d = v.find(delim, std::max(bounds[k - 1], v.size() * k / n_chunks));
+                    bounds[k] = d == std::string_view::npos ? v.size() : d + 1;
+                }
+
+                std::vector<size_t> offsets(n_chunks + 1, 0);   // index in `out` of the first element of every chunk
+                parallel_for(n_chunks, [&](size_t k) {
+                    const std::string_view chunk = v.substr(bounds[k], bounds[k + 1] - bounds[k]);
+                    offsets[k + 1] = bounds[k + 1] < v.size() ? count_char(chunk, delim) : count_split(chunk, delim);   // only the chunk at the end may lack a final delimiter
+                });
+                for (size_t k = 0; k < n_chunks; k++)
+                    offsets[k + 1] += offsets[k];
+
+                out.clear();
+                out.resize(n);
+                std::vector<ChunkError> errors(n_chunks);
+                parallel_for(n_chunks, [&](size_t k) {
+                    size_t i = offsets[k];
+                    for_each_split(v.substr(bounds[k], bounds[k + 1] - bounds[k]), [&](std::string_view element) {
+                        if (errors[k].code != ErrorCode::NONE)
+                            return;
+                        const ErrorCode code = try_convert(element, out[i]);
+                        if (code != ErrorCode::NONE)
+                            errors[k] = {i, code, element};
+                        i++;
+                    }, delim);
+                });
+                const ChunkError error = first_error(errors);
+                if (error.code != ErrorCode::NONE) {
+                    out.resize(error.index);    // like the sequential conversion, keep the elements before the first error
+                    failed = error.value;
+                }
+                return error.code;
+            }
         }
 
-        // Allow both string inputs and direct-type inputs. Where a string-input will be converted like it would when using the commandline, and the direct approach is to simply use the value provided.
-        template <typename T> Entry &set_default(const T &default_value) {
-            this->default_str_ = toString(default_value);
-            if constexpr (!(std::is_array<T>::value || std::is_same<typename std::remove_all_extents<T>::type, char>::value)) {
-                data_default = std::make_unique<ConvertType<T>>(default_value);
+        out.clear();
+        out.reserve(n);
+        ErrorCode code = ErrorCode::NONE;
+        for_each_split(v, [&](std::string_view element) {
+            if (code == ErrorCode::NONE) {
+                code = try_emplace_back(out, element, detail);
+                if (code != ErrorCode::NONE)
+                    failed = element;
+            }
+        }, delim);
+        return code;
+    }
+
+    /* Convert `v` into an existing object without exceptions, reusing its storage where possible. Vectors are split straight into `out`, which is
+     * reserved for the exact number of elements up front, without creating intermediate strings.
+     * Custom types are converted by `get<T>`, which reports errors by throwing.
+     */
+    template<typename T> inline ErrorCode try_convert(std::string_view v, T &out, std::string *detail) {
+        if constexpr (is_vector<T>::value) {
+            std::string_view failed;
+            return try_convert_split(v, out, failed, ',', detail);
+        } else if constexpr (std::is_same<T, std::string>::value || std::is_same<T, std::pmr::string>::value) {
+            out.assign(v.data(), v.size());
+#ifdef __cpp_char8_t
+        } else if constexpr (std::is_same<T, std::u8string>::value) {
+            if (!is_valid_utf8(v))
+                return ErrorCode::INVALID_VALUE;
+            out.assign(reinterpret_cast<const char8_t *>(v.data()), v.size());
+#endif
+        } else if constexpr (is_unicode_string<T>::value) {
+            return utf8_decode(v, out) ? ErrorCode::NONE : ErrorCode::INVALID_VALUE;
+        } else if constexpr (std::is_same<T, mapped_file>::value) {
+            if (!out.open(v))
+                return custom_error(detail, "could not open file: " + std::generic_category().message(errno));
+        } else if constexpr (is_deferred<T>::value) {     // only checked, the conversion itself is deferred until the value is accessed
+            if (!out.set(v))
+                return ErrorCode::INVALID_VALUE;
+        } else if constexpr (is_mapped_span<T>::value) {
+            std::string error = out.open(v);
+            if (!error.empty())
+                return custom_error(detail, std::move(error));
+        } else if constexpr (std::is_same<T, std::filesystem::path>::value) {
+            if constexpr (std::is_same<std::filesystem::path::value_type, char>::value) {   // native paths are bytes, which are kept as they are
+                out.assign(v.begin(), v.end());
+            } else {
+                std::basic_string<std::filesystem::path::value_type> native;
+                if (!utf8_decode(v, native))
+                    return ErrorCode::INVALID_VALUE;
+                out = std::move(native);
+            }
+        } else if constexpr (std::is_same<T, bool>::value) {
+            out = iequals(v, "true") || v == "1";
+        } else if constexpr (std::is_same<T, char>::value || std::is_same<T, signed char>::value || std::is_same<T, unsigned char>::value) {
+            if (v.size() == 1) {
+                out = (T)v[0];  // single characters are taken literally, while longer input is read as a number, e.g. "0x41" or "65" for 'A'
+                return ErrorCode::NONE;
+            }
+            int c = 0;
+            const ErrorCode code = to_error_code(parse_number(v, c));
+            if (code != ErrorCode::NONE)
+                return code;
+            if (c < std::numeric_limits<T>::min() || c > std::numeric_limits<T>::max())
+                return ErrorCode::OUT_OF_RANGE;
+            out = (T)c;
+        } else if constexpr (std::is_arithmetic<T>::value) {
+            return to_error_code(parse_number(v, out));
+        } else if constexpr (std::is_enum<T>::value) {  // case-insensitive enum conversion
+#ifdef HAS_MAGIC_ENUM
+            if (EnumTable<T>::find(v, out))
+                return ErrorCode::NONE;
+#endif
+            return ErrorCode::NOT_ALLOWED;
+        } else if constexpr (is_optional<T>::value) {
+            if constexpr (std::is_default_constructible<typename T::value_type>::value) {
+                out.emplace();
+                const ErrorCode code = try_convert(v, *out, detail);
+                if (code != ErrorCode::NONE)
+                    out.reset();
+                return code;
+            } else {
+                out = get<T>(v);
+            }
+        } else if constexpr (std::is_pointer<T>::value || is_shared_ptr<T>::value) {
+            using E = typename std::pointer_traits<T>::element_type;
+            if constexpr (std::is_default_constructible<E>::value) {
+                E value{};
+                const ErrorCode code = try_convert(v, value, detail);
+                if (code != ErrorCode::NONE)
+                    return code;
+                if constexpr (std::is_pointer<T>::value)
+                    out = new E(std::move(value));
+                else
+                    out = std::make_shared<E>(std::move(value));
+            } else {
+                out = get<T>(v);
+            }
+        } else {
+            out = get<T>(v);
+        }
+        return ErrorCode::NONE;
+    }
+
+    // Throw the exception that `get<T>` raises for a conversion error, where `detail` is the message of an ErrorCode::CUSTOM
+    template <typename T> [[noreturn]] void throw_convert_error(ErrorCode code, const std::string &detail=std::string()) {
+        if (code == ErrorCode::OUT_OF_RANGE)
+            ARGPARSE_THROW(std::out_of_range("value out of range"));
+        if (code == ErrorCode::NOT_ALLOWED)
+            ARGPARSE_THROW(std::runtime_error(not_allowed_message(allowed_values<T>())));
+        if (code == ErrorCode::CUSTOM)
+            ARGPARSE_THROW(std::runtime_error(detail));
+        ARGPARSE_THROW(std::invalid_argument("not a number"));
+    }
+
+    // Throwing counterpart of `parse_number`
+    template <typename T> T get_number(std::string_view v) {
+        T res{};
+        const ErrorCode code = to_error_code(parse_number(v, res));
+        if (code != ErrorCode::NONE)
+            throw_convert_error<T>(code);
+        return res;
+    }
+
+    // Throwing counterpart of `try_convert`
+    template<typename T> inline void convert_into(std::string_view v, T &out) {
+        std::string detail;
+        const ErrorCode code = try_convert(v, out, &detail);
+        if (code != ErrorCode::NONE)
+            throw_convert_error<T>(code, detail);
+    }
+
+    template<typename T> inline T get(std::string_view v) {
+        if constexpr (is_vector<T>::value || std::is_arithmetic<T>::value || std::is_enum<T>::value
+                      || std::is_same<T, std::string>::value || is_unicode_string<T>::value || std::is_same<T, std::filesystem::path>::value) {
+            T res{};
+            convert_into(v, res);
+            return res;
+        } else if constexpr (std::is_pointer<T>::value) {
+            return new typename std::remove_pointer<T>::type(get<typename std::remove_pointer<T>::type>(v));
+        } else if constexpr (is_shared_ptr<T>::value) {
+            return std::make_shared<typename T::element_type>(get<typename T::element_type>(v));
+        } else if constexpr (is_optional<T>::value) {
+            return get<typename T::value_type>(v);
+        } else if constexpr (std::is_constructible<T, std::string_view>::value) {
+            return T(v);
+        } else {
+            return T(std::string(v));   // only types that are exclusively constructible from an owning string pay for the copy
+        }
+    }
+
+    /* A list of which the elements are only converted when they are iterated, one at a time, instead of all at once while parsing. It holds views of
+     * the program arguments, or of a comma-separated argument, such that its size is known without converting and its memory use does not grow with
+     * the number of elements. Invalid elements raise an error when they are reached, like `get<T>`. Use it together with `multi_argument()`, e.g.
+     *      argparse::lazy_list<std::string_view> &files = arg("Files to process").multi_argument();
+     *      for (std::string_view file : files) ...
+     * The views refer to argv and to the parser, which must both outlive the list
+     */
+    template <typename T> class lazy_list {
+    public:
+        using value_type = T;
+
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = T;    // elements are converted on every dereference
+
+            iterator() = default;
+
+            T operator*() const { return get<T>(current_); }
+            [[nodiscard]] std::string_view raw() const { return current_; }     // the element before conversion
+
+            iterator &operator++() {
+                if (++i_ < list_->n_)
+                    load();
+                return *this;
+            }
+            iterator operator++(int) { iterator res = *this; ++*this; return res; }
+            bool operator==(const iterator &other) const { return i_ == other.i_; }
+            bool operator!=(const iterator &other) const { return i_ != other.i_; }
+
+        private:
+            const lazy_list *list_ = nullptr;
+            size_t i_ = 0;
+            std::string_view current_;
+            std::string_view rest_;     // the elements after the current one, of a comma-separated argument
+
+            iterator(const lazy_list *list, size_t i) : list_(list), i_(i), rest_(list->joined_) {
+                if (i_ < list_->n_)
+                    load();
+            }
+
+            void load() {
+                if (list_->tokens_ != nullptr) {
+                    current_ = list_->tokens_[i_];
+                } else {
+                    const size_t d = rest_.find(',');
+                    current_ = rest_.substr(0, d);
+                    rest_ = d == std::string_view::npos ? std::string_view() : rest_.substr(d + 1);
+                }
+            }
+
+            friend class lazy_list;
+        };
+
+        lazy_list() = default;
+        explicit lazy_list(std::string_view joined) : joined_(joined), n_(count_split(joined)) {}
+        lazy_list(const std::string_view *tokens, size_t n) : tokens_(tokens), n_(n) {}
+
+        [[nodiscard]] size_t size() const { return n_; }
+        [[nodiscard]] bool empty() const { return n_ == 0; }
+        [[nodiscard]] iterator begin() const { return iterator(this, 0); }
+        [[nodiscard]] iterator end() const { return iterator(this, n_); }
+
+    private:
+        const std::string_view *tokens_ = nullptr;  // the program arguments, or nullptr for the elements of a comma-separated argument
+        std::string_view joined_;
+        size_t n_ = 0;
+    };
+
+    /* Cheap check of the raw value of a deferred<T> while parsing, e.g. that a file exists, which may be specialised for T.
+     * By default, a T with a static member function `bool validate(std::string_view)` is checked with it, and any other value is accepted
+     */
+    template <typename T, typename = void> struct deferred_check {
+        static bool valid(std::string_view) { return true; }
+    };
+    template <typename T> struct deferred_check<T, std::void_t<decltype(T::validate(std::string_view()))>> {
+        static bool valid(std::string_view v) { return T::validate(v); }
+    };
+
+    /* A value of which the (expensive) conversion is deferred until it is first accessed, where only `deferred_check<T>` runs while parsing.
+     * The raw value is copied, so it does not depend on argv. The conversion runs once, also when accessed from multiple threads, and can be
+     * started in the background with `prefetch`, or right after parsing with `Entry::prefetch`. Copies share the same value
+     */
+    template <typename T> class deferred {
+        struct State {
+            std::string raw;
+            std::once_flag converted;
+            std::once_flag started;
+            std::optional<T> value;
+#ifdef ARGPARSE_HAS_EXCEPTIONS
+            std::exception_ptr error;   // rethrown on every access, the conversion is not retried
+#endif
+            std::thread prefetcher;     // refers to the state by pointer, and is joined before the state is destroyed
+
+            ~State() {
+                if (prefetcher.joinable())
+                    prefetcher.join();
+            }
+
+            void convert() {
+                std::call_once(converted, [this] {
+#ifdef ARGPARSE_HAS_EXCEPTIONS
+                    try {
+                        value.emplace(argparse::get<T>(raw));
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+#else
+                    value.emplace(argparse::get<T>(raw));
+#endif
+                });
+            }
+        };
+        std::shared_ptr<State> state_;
+
+    public:
+        using element_type = T;
+
+        deferred() = default;
+        explicit deferred(std::string_view v) {
+            if (!set(v))
+                ARGPARSE_THROW(std::invalid_argument("invalid value"));
+        }
+
+        // Replace the value by the raw value `v`, which is not converted yet. Returns false (and keeps the current value) when `deferred_check<T>` rejects it
+        bool set(std::string_view v) {
+            if (!deferred_check<T>::valid(v))
+                return false;
+            state_ = std::make_shared<State>();
+            state_->raw = v;
+            return true;
+        }
+
+        // The converted value, which is converted by the first call. Throws the error of the conversion, or when there is no value at all
+        [[nodiscard]] const T &get() const {
+            if (state_ == nullptr)
+                ARGPARSE_THROW(std::runtime_error("deferred value is not set"));
+            state_->convert();
+#ifdef ARGPARSE_HAS_EXCEPTIONS
+            if (state_->error != nullptr)
+                std::rethrow_exception(state_->error);
+#endif
+            return *state_->value;
+        }
+        [[nodiscard]] const T &operator*() const { return get(); }
+        [[nodiscard]] const T *operator->() const { return &get(); }
+
+        // Start the conversion on a background thread, if it has not been started yet. Without threads, it is converted on first access instead
+        void prefetch() const {
+            if (state_ == nullptr)
+                return;
+            std::call_once(state_->started, [state = state_.get()] {
+#ifdef ARGPARSE_HAS_EXCEPTIONS
+                try {
+                    state->prefetcher = std::thread([state] { state->convert(); });
+                } catch (const std::system_error &) {}
+#else
+                state->prefetcher = std::thread([state] { state->convert(); });
+#endif
+            });
+        }
+
+        [[nodiscard]] bool has_value() const { return state_ != nullptr; }
+        [[nodiscard]] std::string_view raw() const { return state_ != nullptr ? std::string_view(state_->raw) : std::string_view(); }
+
+        // Printed as its raw value, without converting it
+        friend std::ostream &operator<<(std::ostream &os, const deferred &value) { return os << value.raw(); }
+    };
+
+    // Construct a T that allocates from `resource` if it is allocator-aware with a polymorphic allocator (e.g. std::pmr::vector), otherwise a plain T
+    template <typename T, typename... A> T make_with_resource(std::pmr::memory_resource *resource, A &&...args) {
+        if constexpr (std::uses_allocator<T, std::pmr::polymorphic_allocator<char>>::value && std::is_constructible<T, A..., std::pmr::polymorphic_allocator<char>>::value)
+            return T(std::forward<A>(args)..., std::pmr::polymorphic_allocator<char>(resource));
+        else
+            return T(std::forward<A>(args)...);
+    }
+
+    // Operations on a type-erased value, one table per type, which is resolved when the type of an Entry becomes known
+    struct ConvertOps {
+        size_t size;
+        size_t alignment;
+        void (*destroy)(void *value);
+        ErrorCode (*convert)(void *value, std::string_view v, std::string_view &failed, std::string *detail);
+        ErrorCode (*convert_multi)(void *value, const std::string_view *values, size_t n, size_t &i, std::string *detail);
+        void (*assign)(void *value, const void *other);
+        ErrorCode (*check)(std::string_view v, std::string_view &failed, std::string *detail, std::shared_ptr<void> *keep);
+        ErrorCode (*check_multi)(const std::string_view *values, size_t n, size_t &i, std::string *detail, std::shared_ptr<void> *keep);
+        std::string (*allowed_entries)();
+        std::string (*to_string)(const void *value);
+    };
+
+    template <typename T> struct ConvertType {
+        static void destroy(void *value) {
+            static_cast<T*>(value)->~T();
+        }
+
+        /* Convert a single program argument, where `failed` is narrowed down to the element that failed to convert for vectors, and `detail`
+         * receives the message of an ErrorCode::CUSTOM
+         */
+        static ErrorCode convert(void *value, std::string_view v, std::string_view &failed, std::string *detail) {
+            if constexpr (is_vector<T>::value)
+                return try_convert_split(v, *static_cast<T*>(value), failed, ',', detail);
+            else
+                return try_convert(v, *static_cast<T*>(value), detail);
+        }
+
+        // Convert multiple program arguments token by token, `i` is left at the token that failed to convert
+        static ErrorCode convert_multi(void *value, const std::string_view *values, size_t n, size_t &i, std::string *detail) {
+            T &data = *static_cast<T*>(value);
+            if constexpr (is_vector<T>::value) {
+                if constexpr (std::is_arithmetic<typename T::value_type>::value && !std::is_same<typename T::value_type, bool>::value) {
+                    if (n == 1 && values[0].substr(0, 2) == "@@") {    // numbers that are loaded from a file
+                        std::string_view failed;
+                        i = 0;
+                        return try_convert_split(values[0], data, failed, ',', detail);
+                    }
+                }
+                if constexpr (is_parallel_convertible<typename T::value_type>()) {
+                    if (n >= parallel_threshold) {  // convert chunks of tokens on all cores, straight into their place in `data`
+                        constexpr size_t chunk = 1024;
+                        const size_t n_chunks = (n + chunk - 1) / chunk;
+                        data.clear();
+                        data.resize(n);
+                        std::vector<ChunkError> errors(n_chunks);
+                        parallel_for(n_chunks, [&](size_t k) {
+                            for (size_t j = k * chunk; j < std::min(n, (k + 1) * chunk); j++) {
+                                const ErrorCode code = try_convert(values[j], data[j]);
+                                if (code != ErrorCode::NONE) {
+                                    errors[k] = {j, code, values[j]};
+                                    return;
+                                }
+                            }
+                        });
+                        const ChunkError error = first_error(errors);
+                        if (error.code != ErrorCode::NONE) {
+                            data.resize(error.index);
+                            i = error.index;
+                        }
+                        return error.code;
+                    }
+                }
+                data.clear();
+                data.reserve(n);
+                for (i = 0; i < n; i++) {
+                    const ErrorCode code = try_emplace_back(data, values[i], detail);
+                    if (code != ErrorCode::NONE)
+                        return code;
+                }
+                return ErrorCode::NONE;
+            } else if constexpr (is_lazy_list<T>::value) {     // keeps the views of the arguments, which are converted when iterated
+                data = T(values, n);
+                return ErrorCode::NONE;
+            } else {    // types that are not a container receive all arguments as 1 comma-separated string
+                std::string joined;
+                for (size_t j = 0; j < n; j++)
+                    (joined += (j? "," : "")) += values[j];
+                return try_convert(joined, data, detail);
+            }
+        }
+
+        static void assign(void *value, const void *other) {
+            if constexpr (is_copy_assignable<T>::value)     // defaults can only be given as a string for types that can not be copied, e.g. a mapped_file
+                *static_cast<T*>(value) = *static_cast<const T*>(other);
+        }
+
+        /* Whether a value that is converted by `check` can be kept, to be copied out later instead of being converted again. A lazy_list is not kept,
+         * since it refers to the tokens that were checked rather than to those of the ParsedArgs
+         */
+        static constexpr bool keepable = std::is_copy_constructible<T>::value && !std::is_pointer<T>::value && !is_lazy_list<T>::value;
+
+        /* Convert into a temporary, to validate a value without storing it in an entry. The converted value is moved into `keep` when given,
+         * for types that are keepable, and otherwise discarded
+         */
+        static ErrorCode check(std::string_view v, std::string_view &failed, std::string *detail, std::shared_ptr<void> *keep) {
+            if constexpr (keepable) {
+                if (keep != nullptr) {
+                    std::shared_ptr<T> value = std::make_shared<T>();
+                    const ErrorCode code = convert(value.get(), v, failed, detail);
+                    if (code == ErrorCode::NONE)
+                        *keep = std::move(value);
+                    return code;
+                }
+            }
+            T value{};
+            const ErrorCode code = convert(&value, v, failed, detail);
+            if constexpr (std::is_pointer<T>::value)
+                delete value;
+            return code;
+        }
+
+        static ErrorCode check_multi(const std::string_view *values, size_t n, size_t &i, std::string *detail, std::shared_ptr<void> *keep) {
+            if constexpr (keepable) {
+                if (keep != nullptr) {
+                    std::shared_ptr<T> value = std::make_shared<T>();
+                    const ErrorCode code = convert_multi(value.get(), values, n, i, detail);
+                    if (code == ErrorCode::NONE)
+                        *keep = std::move(value);
+                    return code;
+                }
+            }
+            T value{};
+            const ErrorCode code = convert_multi(&value, values, n, i, detail);
+            if constexpr (std::is_pointer<T>::value)
+                delete value;
+            return code;
+        }
+
+        static std::string allowed_entries() {
+            return allowed_values<T>();
+        }
+
+        static std::string to_string(const void *value) {
+            return toString(*static_cast<const T*>(value));
+        }
+
+        static constexpr ConvertOps ops = {sizeof(T), alignof(T), destroy, convert, convert_multi, assign, check, check_multi, allowed_entries, to_string};
+    };
+
+    /* Type-erased storage of the value of an Entry together with its default value, which share a single slot: both are stored inline when they fit,
+     * otherwise in one allocation from the memory resource. Since references to the value are handed out, a slot can not be copied or moved
+     */
+    class ValueSlot {
+    public:
+        static constexpr size_t inline_size = 4 * sizeof(void*);
+
+        explicit ValueSlot(std::pmr::memory_resource *resource) : resource_(resource) {}
+        ValueSlot(const ValueSlot &) = delete;
+        ValueSlot &operator=(const ValueSlot &) = delete;
+        ~ValueSlot() { clear(); }
+
+        [[nodiscard]] std::pmr::memory_resource *resource() const { return resource_; }
+
+        // Store a default value, before the type of the value is known. Room for a value of the same type is reserved next to it
+        template <typename T> void set_default(const T &default_value) {
+            clear();
+            BlockGuard guard{*this, allocate(ConvertType<T>::ops, 2), ConvertType<T>::ops, 2};
+            default_ = ::new (guard.block) T(make_with_resource<T>(resource_, default_value));
+            guard.block = nullptr;
+            ops_ = &ConvertType<T>::ops;
+        }
+
+        // Construct the value, keeping the default when it has the same type. Defaults of another type are dropped, to be converted from their string instead
+        template <typename T> T &emplace() {
+            const ConvertOps &ops = ConvertType<T>::ops;
+            if (ops_ != &ops)
+                clear();
+            void *block = default_ != nullptr ? static_cast<char*>(default_) + stride(ops) : allocate(ops, 1);
+            BlockGuard guard{*this, default_ != nullptr ? nullptr : block, ops, 1};   // a block that is shared with the default is released with the default
+            value_ = ::new (block) T(make_with_resource<T>(resource_));
+            guard.block = nullptr;
+            ops_ = &ops;
+            return *static_cast<T*>(value_);
+        }
+
+        [[nodiscard]] bool has_default() const { return default_ != nullptr; }
+        template <typename T> [[nodiscard]] bool holds() const { return ops_ == &ConvertType<T>::ops; }
+        template <typename T> [[nodiscard]] T *value() { return value_ != nullptr && holds<T>() ? static_cast<T*>(value_) : nullptr; }
+        ErrorCode convert(std::string_view v, std::string_view &failed, std::string *detail) { return ops_->convert(value_, v, failed, detail); }
+        ErrorCode convert_multi(const std::string_view *values, size_t n, size_t &i, std::string *detail) { return ops_->convert_multi(value_, values, n, i, detail); }
+        void apply_default() { ops_->assign(value_, default_); }
+        [[nodiscard]] ErrorCode check(std::string_view v, std::string_view &failed, std::string *detail, std::shared_ptr<void> *keep=nullptr) const { return ops_->check(v, failed, detail, keep); }
+        [[nodiscard]] ErrorCode check_multi(const std::string_view *values, size_t n, size_t &i, std::string *detail, std::shared_ptr<void> *keep=nullptr) const { return ops_->check_multi(values, n, i, detail, keep); }
+
+        // The default value if it is of type T, otherwise nullptr
+        template <typename T> [[nodiscard]] const T *default_value() const {
+            return default_ != nullptr && holds<T>() ? static_cast<const T*>(default_) : nullptr;
+        }
+        [[nodiscard]] std::string allowed_entries() const { return ops_->allowed_entries(); }
+        [[nodiscard]] std::string to_string() const { return ops_->to_string(value_); }
+        [[nodiscard]] std::string default_to_string() const { return ops_->to_string(default_); }
+
+        // Destroy the value and the default
+        void clear() {
+            if (ops_ == nullptr)
+                return;
+            if (value_ != nullptr)
+                ops_->destroy(value_);
+            if (default_ != nullptr)
+                ops_->destroy(default_);
+            deallocate(default_ != nullptr ? default_ : value_, *ops_, default_ != nullptr ? 2 : 1);
+            ops_ = nullptr;
+            value_ = default_ = nullptr;
+        }
+
+    private:
+        alignas(std::max_align_t) unsigned char buffer_[inline_size];
+        std::pmr::memory_resource *resource_;
+        const ConvertOps *ops_ = nullptr;   // operations of the value and the default, which are always of the same type
+        void *value_ = nullptr;
+        void *default_ = nullptr;           // when set, the value is stored right after it in the same block
+
+        // Releases a block when constructing a value in it fails
+        struct BlockGuard {
+            ValueSlot &slot;
+            void *block;
+            const ConvertOps &ops;
+            size_t n;
+            ~BlockGuard() {
+                if (block != nullptr)
+                    slot.deallocate(block, ops, n);
+            }
+        };
+
+        static size_t stride(const ConvertOps &ops) {
+            return (ops.size + ops.alignment - 1) / ops.alignment * ops.alignment;
+        }
+
+        void *allocate(const ConvertOps &ops, size_t n) {
+            if (stride(ops) * n <= inline_size && ops.alignment <= alignof(std::max_align_t))
+                return buffer_;
+            return resource_->allocate(stride(ops) * n, ops.alignment);
+        }
+
+        void deallocate(void *block, const ConvertOps &ops, size_t n) {
+            if (block != buffer_)
+                resource_->deallocate(block, stride(ops) * n, ops.alignment);
+        }
+    };
+
+    // A comma-separated list of keys, e.g. "k,key", which is iterated in place instead of being split into separate strings
+    class KeyList {
+        std::string_view keys_;
+
+    public:
+        class iterator {
+            const char *pos_ = nullptr;     // start of the current key, nullptr at the end
+            const char *end_ = nullptr;     // end of the whole list
+            std::string_view key_;
+
+            constexpr void load(const char *p) {
+                const char *c = p;
+                while (c != end_ && *c != ',')
+                    ++c;
+                pos_ = p;
+                key_ = std::string_view(p, size_t(c - p));
+            }
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view *;
+            using reference = const std::string_view &;
+
+            constexpr iterator() = default;
+            constexpr explicit iterator(std::string_view keys) : end_(keys.data() + keys.size()) { load(keys.data()); }
+            constexpr reference operator*() const { return key_; }
+            constexpr pointer operator->() const { return &key_; }
+            constexpr iterator &operator++() {
+                const char *next = pos_ + key_.size();
+                if (next == end_) {
+                    pos_ = nullptr;
+                    key_ = std::string_view();
+                } else {
+                    load(next + 1);
+                }
+                return *this;
+            }
+            constexpr iterator operator++(int) { iterator res = *this; ++*this; return res; }
+            constexpr bool operator==(const iterator &other) const { return pos_ == other.pos_; }
+            constexpr bool operator!=(const iterator &other) const { return pos_ != other.pos_; }
+        };
+
+        constexpr KeyList() = default;
+        constexpr explicit KeyList(std::string_view keys) : keys_(keys) {}
+
+        [[nodiscard]] constexpr iterator begin() const { return keys_.empty() ? end() : iterator(keys_); }
+        [[nodiscard]] constexpr iterator end() const { return iterator(); }
+        [[nodiscard]] constexpr size_t size() const { return keys_.empty() ? 0 : (size_t)std::count(keys_.begin(), keys_.end(), ',') + 1; }
+        [[nodiscard]] constexpr std::string_view operator[](size_t i) const {
+            iterator it = begin();
+            while (i-- > 0)
+                ++it;
+            return *it;
+        }
+        [[nodiscard]] constexpr std::string_view str() const { return keys_; }
+    };
+
+    struct Entry {
+        enum ARG_TYPE {ARG, KWARG, FLAG} type;
+
+        // All strings and converted values of the entry are allocated from `resource`
+        Entry(ARG_TYPE type, std::string_view key, std::string_view help, const std::optional<std::string> &implicit_value=std::nullopt,
+              std::pmr::memory_resource *resource=std::pmr::get_default_resource()) :
+                type(type),
+                data_(resource),
+                key_storage_(key, resource),
+                keys_(key_storage_),
+                help(help, resource) {
+            if (implicit_value.has_value())
+                implicit_value_.emplace(*implicit_value, resource);
+        }
+
+        // Construct from keys with static storage duration, such as the keys of a `Schema`, which are not copied
+        Entry(ARG_TYPE type, KeyList static_keys, std::string_view help, const std::optional<std::string> &implicit_value=std::nullopt,
+              std::pmr::memory_resource *resource=std::pmr::get_default_resource()) :
+                type(type),
+                data_(resource),
+                key_storage_(resource),
+                keys_(static_keys),
+                help(help, resource),
+                from_schema_(true) {
+            if (implicit_value.has_value())
+                implicit_value_.emplace(*implicit_value, resource);
+        }
+
+        /* Allow both string inputs and direct-type inputs. Where a string-input will be converted like it would when using the commandline, and the direct approach is to simply use the value provided.
+         * Direct-type inputs are stored as they are, and only turned into a string when it is needed, e.g. for the help
+         */
+        template <typename T> Entry &set_default(const T &default_value) {
+            if constexpr (std::is_array<T>::value || std::is_same<typename std::remove_all_extents<T>::type, char>::value) {
+                data_.clear();
+                this->default_str_.emplace(toString(default_value), data_.resource());
+            } else {
+                this->default_str_.reset();
+                data_.set_default(default_value);
+            }
+            return *this;
+        }
+
+        Entry &multi_argument() {
+            _is_multi_argument = true;
+            return *this;
+        }
+
+        /* Convert this entry concurrently with the other independent entries once all arguments have been found, for custom types of which
+         * the conversion does real work (e.g. loading a model or opening a database). The conversion must not depend on other entries
+         */
+        Entry &independent() {
+            independent_ = true;
+            return *this;
+        }
+
+        // Start converting the deferred<T> of this entry on a background thread as soon as parsing succeeded, see `deferred::prefetch`
+        Entry &prefetch() {
+            prefetch_ = true;
+            return *this;
+        }
+
+        // How the mapped_file (or the vector of mapped_files) of this entry will be accessed, which is passed on to `mapped_file::advise` once it is mapped
+        Entry &advise(mapped_file::advice hint) {
+            advice_ = hint;
+            return *this;
+        }
+
+        // Magically convert the value string to the requested type
+        template <typename T> operator T&() {
+            // Automatically set the default to nullptr for pointer types and empty for optional types
+            if constexpr (is_optional<T>::value || std::is_pointer<T>::value || is_shared_ptr<T>::value) {
+                if (!_has_default()) {
+                    if constexpr(is_optional<T>::value) {
+                        data_.set_default(T{std::nullopt});
+                    } else {
+                        data_.set_default((T) nullptr);
+                    }
+                }
+            }
+
+            if constexpr (is_lazy_list<T>::value)
+                keeps_tokens_ = true;
+            if constexpr (is_deferred<T>::value)
+                start_prefetch_ = [](ValueSlot &data) { if (const T *value = data.value<T>()) value->prefetch(); };
+
+            if (data_.has_default() && !data_.holds<T>())  // a default of another type (e.g. an int for a double) is converted from its string instead
+                default_str_.emplace(data_.default_to_string(), data_.resource());
+            return data_.emplace<T>();
+        }
+
+        // Force an ambiguous error when not using a reference.
+        template <typename T> operator T() {} // When you get here  because you received an error, make sure all parameters of argparse are references (e.g. with `&`)
+
+    private:
+        ValueSlot data_;                            // the converted value and its default
+        std::pmr::string key_storage_;              // owns the keys when they are provided at runtime
+        KeyList keys_;
+        std::pmr::string help;
+        std::optional<std::string_view> value_;     // view of the raw input, pointing into argv or into one of the owned strings below
+        bool value_from_data_ = false;              // multi-arguments and typed defaults have no raw input, these are printed from the converted data instead
+        std::optional<std::pmr::string> implicit_value_;
+        std::optional<std::pmr::string> default_str_;  // only for defaults given as a string, typed defaults are stored in data_
+        ErrorCode error_code_ = ErrorCode::NONE;    // the error of the last parse, of which the message is only built when it is requested
+        std::string_view error_value_;              // the value that caused the error, a view like `value_`
+        std::string error;                          // message of the exception thrown by a custom type, which is not allocated from the memory resource
+        bool _is_multi_argument = false;
+        bool is_set_by_user = true;
+        bool from_schema_ = false;
+        size_t index_ = 0;                          // position in Args::all_entries, which also locates the value of this entry in a ParsedArgs
+        bool keeps_tokens_ = false;                 // the value refers to the tokens of the parser, as a lazy_list does
+        mapped_file::advice advice_ = mapped_file::advice::normal;
+        bool independent_ = false;
+        bool prefetch_ = false;
+        void (*start_prefetch_)(ValueSlot &data) = nullptr;   // starts the prefetch of a deferred<T>, nullptr for other types
+
+        [[nodiscard]] std::string _get_keys() const {
+            std::stringstream ss;
+            for (size_t i = 0; i < keys_.size(); i++)
+                ss << (i? "," : "") << (type == ARG? "" : (keys_[i].size() > 1 ? "--" : "-")) << keys_[i];
+            return ss.str();
+        }
+
+        [[nodiscard]] bool _has_default() const {
+            return default_str_.has_value() || data_.has_default();
+        }
+
+        [[nodiscard]] std::string _default_string() const {
+            return default_str_.has_value() ? std::string(*default_str_) : data_.default_to_string();
+        }
+
+        // The keys and help of this entry, as used in error messages
+        [[nodiscard]] std::string _describe() const {
+            return _get_keys() + " (" + std::string(help) + ")";
+        }
+
+        // Clear the result of a previous parse, the converted data itself is overwritten by the next parse
+        void _reset() {
+            value_.reset();
+            value_from_data_ = false;
+            error_code_ = ErrorCode::NONE;
+            error_value_ = std::string_view();
+            error.clear();
+            is_set_by_user = true;
+        }
+
+        void _set_error(ErrorCode code, std::string_view value) {
+            if (code != ErrorCode::NONE) {
+                error_code_ = code;
+                error_value_ = value;
+            }
+        }
+
+        /* Run a conversion, where the exceptions that custom types use to report errors are turned into an error code.
+         * The message of such an exception is stored in `detail`, which built-in conversions are given to store the message of their ErrorCode::CUSTOM
+         */
+        template <typename F> static ErrorCode _guard(F &&convert, std::string &detail) {
+#ifdef ARGPARSE_HAS_EXCEPTIONS
+            try {
+                return convert();
+            } catch (const std::invalid_argument &e) {
+                return ErrorCode::INVALID_VALUE;
+            } catch (const std::out_of_range &e) {
+                detail = e.what();
+            } catch (const std::runtime_error &e) {
+                detail = e.what();
+            }
+            return ErrorCode::CUSTOM;
+#else
+            (void)detail;
+            return convert();
+#endif
+        }
+
+        void _convert(std::string_view value) {
+            this->value_ = value;
+            this->value_from_data_ = false;
+            std::string_view failed = value;    // narrowed down to the failing element of a list
+            const ErrorCode code = _guard([&] { return data_.convert(value, failed, &error); }, error);
+            _set_error(code, failed);
+            _advise();
+        }
+
+        void _convert_multi(const std::string_view *values, size_t n) {
+            size_t i = 0;
+            this->value_ = std::string_view();
+            this->value_from_data_ = true;
+            const ErrorCode code = _guard([&] { return data_.convert_multi(values, n, i, &error); }, error);
+            _set_error(code, code != ErrorCode::NONE ? values[i] : std::string_view());
+            _advise();
+        }
+
+        // Pass the access hint on to the files that were just mapped
+        void _advise() {
+            if (advice_ == mapped_file::advice::normal)
+                return;
+            if (const mapped_file *file = data_.value<mapped_file>())
+                file->advise(advice_);
+            if (const std::vector<mapped_file> *files = data_.value<std::vector<mapped_file>>()) {
+                for (const mapped_file &file : *files)
+                    file.advise(advice_);
+            }
+        }
+
+        /* Counterparts of `_convert` and `_convert_multi` that only validate the value, which leave the entry untouched and can be called concurrently.
+         * The converted value is kept in `keep` when given, see `ConvertType::check`
+         */
+        [[nodiscard]] ErrorCode _check(std::string_view value, std::string_view &failed, std::string &detail, std::shared_ptr<void> *keep=nullptr) const {
+            failed = value;
+            return _guard([&] { return data_.check(value, failed, &detail, keep); }, detail);
+        }
+
+        [[nodiscard]] ErrorCode _check_multi(const std::string_view *values, size_t n, size_t &i, std::string &detail, std::shared_ptr<void> *keep=nullptr) const {
+            return _guard([&] { return data_.check_multi(values, n, i, &detail, keep); }, detail);
+        }
+
+        void _apply_default() {
+            is_set_by_user = false;
+            if (data_.has_default()) {
+                value_ = std::string_view();
+                value_from_data_ = true;
+                data_.apply_default();
+            } else if (default_str_.has_value()) {   // in cases where a string, or a value of another type, is provided to the `set_default` function
+                _convert(default_str_.value());
+            } else if (error_code_ == ErrorCode::NONE) {   // a key without a value is reported as such
+                error_code_ = ErrorCode::MISSING_ARGUMENT;
+            }
+        }
+
+        [[nodiscard]] std::string _error_message() const {
+            return _error_message(error_code_, error_value_, error);
+        }
+
+        [[nodiscard]] std::string _error_message(ErrorCode code, std::string_view error_value, const std::string &detail) const {
+            const std::string value(error_value);
+            switch (code) {
+                case ErrorCode::INVALID_VALUE:      return "Invalid argument, could not convert \"" + value + "\" for " + _describe();
+                case ErrorCode::OUT_OF_RANGE:       return "Invalid argument \"" + value + "\" for " + _describe() + ". Error: value out of range";
+                case ErrorCode::NOT_ALLOWED:        return "Invalid argument \"" + value + "\" for " + _describe() + ". Error: " + not_allowed_message(data_.allowed_entries());
+                case ErrorCode::CUSTOM:             return "Invalid argument \"" + value + "\" for " + _describe() + ". Error: " + detail;
+                case ErrorCode::MISSING_VALUE:      return "No value provided for: " + value;
+                case ErrorCode::MISSING_ARGUMENT:   return "Argument missing: " + _describe();
+                default:                            return "";
+            }
+        }
+
+        [[nodiscard]] std::string info() const {
+            const std::string allowed_entries = data_.allowed_entries();
+            const std::string default_value = _has_default() ? "default: " + _default_string() : "required";
+            const std::string implicit_value = implicit_value_.has_value() ? "implicit: \"" + std::string(*implicit_value_) + "\", ": "";
+            const std::string allowed_value = !allowed_entries.empty()? "allowed: <" + allowed_entries + ">, ": "";
+            return " [" + allowed_value + implicit_value + default_value + "]";
+        }
+
+        friend class Args;
+        friend class ParsedArgs;
+        friend struct ParseError;
+    };
+
+    struct SubcommandEntry {
+        std::shared_ptr<Args> subargs;              // nullptr until a lazy subcommand is constructed
+        std::pmr::string subcommand_name;
+
+        explicit SubcommandEntry(std::string_view subcommand_name, std::pmr::memory_resource *resource=std::pmr::get_default_resource()) :
+                subcommand_name(subcommand_name, resource), resource_(resource) {}
+
+        // Returns the subcommand, constructing it first if it is lazy and has not been constructed yet
+        Args &get();
+
+        template<typename T> operator T &() {
+            static_assert(std::is_base_of_v<Args, T>, "Subcommand type must be a derivative of argparse::Args");
+
+            std::shared_ptr<T> res = make_args<T>(resource_);
+            res->program_name = subcommand_name;
+            subargs = res;
+            return *(T*)(subargs.get());
+        }
+
+        // A lazy subcommand, which remains nullptr until it is selected on the commandline (or needed to print the help)
+        template<typename T> operator std::shared_ptr<T> &() {
+            static_assert(std::is_base_of_v<Args, T>, "Subcommand type must be a derivative of argparse::Args");
+
+            lazy_slot = std::allocate_shared<std::shared_ptr<T>>(std::pmr::polymorphic_allocator<std::shared_ptr<T>>(resource_));
+            construct = [](SubcommandEntry &entry) -> std::shared_ptr<Args> {
+                std::shared_ptr<T> &slot = *static_cast<std::shared_ptr<T>*>(entry.lazy_slot.get());
+                slot = make_args<T>(entry.resource_);
+                return slot;
+            };
+            return *static_cast<std::shared_ptr<T>*>(lazy_slot.get());
+        }
+
+        // Force an ambiguous error when not using a reference.
+        template <typename T> operator T() {} // When you get here  because you received an error, make sure all parameters of argparse are references (e.g. with `&`)
+
+    private:
+        std::pmr::memory_resource *resource_;
+        std::shared_ptr<void> lazy_slot;            // the std::shared_ptr<T> that is handed out for lazy subcommands
+        std::shared_ptr<Args> (*construct)(SubcommandEntry &) = nullptr;
+
+        // Allocate the subcommand from `resource`, which is also passed on to the subcommand if it accepts a memory resource
+        template <typename T> static std::shared_ptr<T> make_args(std::pmr::memory_resource *resource) {
+            if constexpr (std::is_constructible<T, std::pmr::memory_resource*>::value)
+                return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource), resource);
+            else
+                return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource));
+        }
+    };
+
+    // An error found while parsing, of which the message is only built when it is requested
+    struct ParseError {
+        ErrorCode code = ErrorCode::NONE;
+        std::string_view key;           // the keys of the argument (e.g. "k,key"), or the unrecognised key
+        std::string_view value;         // the value that caused the error, if any
+        const Entry *entry = nullptr;   // the argument, or nullptr for errors that do not belong to an argument
+        std::string detail;             // the message of the exception thrown by a custom type, if any. Like all error messages, not allocated from the memory resource
+
+        [[nodiscard]] std::string message() const {
+            if (entry != nullptr)
+                return entry->_error_message(code, value, detail);
+            if (code == ErrorCode::UNRECOGNISED_ARGUMENT)
+                return "unrecognised commandline argument :  " + std::string(key);
+            return "response files are nested too deeply: " + std::string(value);
+        }
+    };
+
+    // Result of `Args::try_parse`, which refers to the parsed commandline and remains valid until the next parse
+    struct ParseResult {
+        std::pmr::vector<ParseError> errors;    // all errors, with those of subcommands first and those of arguments in order of declaration
+
+        [[nodiscard]] bool ok() const { return errors.empty(); }
+        explicit operator bool() const { return ok(); }
+    };
+
+    // The program arguments of one commandline, with response files expanded in place
+    struct Tokens {
+        std::pmr::vector<std::string_view> params;                  // views into argv and response files, no copies are made while parsing
+        std::pmr::vector<std::shared_ptr<mapped_file>> files;       // keeps the response files alive, since params and values may refer to their contents
+
+        explicit Tokens(std::pmr::memory_resource *resource=std::pmr::get_default_resource()) : params(resource), files(resource) {}
+
+        [[nodiscard]] bool is_value(size_t i) const {
+            return params.size() > i && (params[i].empty() || params[i][0] != '-' || (params[i].size() > 1 && std::isdigit(params[i][1])));  // check for number to not accidentally mark negative numbers as non-parameter
+        }
+
+        /* Append a program argument, where `@path` is replaced by the arguments in the response file at `path` (if it exists).
+         * `@@path` is never a response file, it is passed on as it is for a vector of numbers (or a mapped_span) to load the binary file at `path`
+         */
+        void add(std::string_view token, std::pmr::vector<ParseError> &errors, int depth=0) {
+            if (token.size() > 1 && token[0] == '@' && token[1] != '@') {
+                std::pmr::memory_resource *resource = params.get_allocator().resource();
+                auto file = std::allocate_shared<mapped_file>(std::pmr::polymorphic_allocator<mapped_file>(resource));
+                if (file->open(token.substr(1))) {
+                    if (depth >= 16) {
+                        errors.push_back({ErrorCode::NESTED_RESPONSE_FILE, std::string_view(), token, nullptr, {}});
+                        return;
+                    }
+                    for_each_response_token(file->view(), [&](std::string_view t) { add(t, errors, depth + 1); });
+                    files.emplace_back(std::move(file));
+                    return;
+                }
+            }
+            params.emplace_back(token);
+        }
+
+        void clear() {
+            params.clear();
+            files.clear();
+        }
+    };
+
+    /* Read-only lookup table from key to value, which is (re)built once all keys have been registered.
+     * Single-character keys are stored in a direct 256-slot table, longer keys in an open-addressing hash table with linear probing.
+     * Keys are stored as views, so the strings they refer to must outlive the index.
+     */
+    template <typename T> class KeyIndex {
+        struct Slot {
+            std::string_view key;
+            T *value = nullptr;
+        };
+        std::array<T*, 256> short_keys_{};
+        std::pmr::vector<Slot> long_keys_;  // capacity is a power of two, and at most half full
+        size_t mask_ = 0;
+
+    public:
+        explicit KeyIndex(std::pmr::memory_resource *resource=std::pmr::get_default_resource()) : long_keys_(resource) {}
+
+        // Remove all keys and reserve room for `n_long_keys` keys of more than 1 character
+        void clear(size_t n_long_keys) {
+            short_keys_.fill(nullptr);
+            size_t capacity = 4;
+            while (capacity < 2 * n_long_keys)
+                capacity *= 2;
+            long_keys_.assign(capacity, Slot{});
+            mask_ = capacity - 1;
+        }
+
+        // Insert or overwrite a key, the last insertion of the same key wins
+        void insert(std::string_view key, T *value) {
+            if (key.size() == 1) {
+                short_keys_[(unsigned char)key[0]] = value;
+                return;
+            }
+            size_t i = hash_key(key) & mask_;
+            while (long_keys_[i].value != nullptr && long_keys_[i].key != key)
+                i = (i + 1) & mask_;
+            long_keys_[i] = Slot{key, value};
+        }
+
+        [[nodiscard]] T *find(std::string_view key) const {
+            if (key.size() == 1)
+                return short_keys_[(unsigned char)key[0]];
+            if (long_keys_.empty())
+                return nullptr;
+            for (size_t i = hash_key(key) & mask_; long_keys_[i].value != nullptr; i = (i + 1) & mask_) {
+                if (long_keys_[i].key == key)
+                    return long_keys_[i].value;
+            }
+            return nullptr;
+        }
+    };
+
+    /* Errors that are raised when a `Schema` is invalid, these are not constexpr such that calling them fails the compilation of a constexpr Schema.
+     * A Schema that is constructed at runtime raises them as an exception instead
+     */
+    inline void schema_error_empty_key() { ARGPARSE_THROW(std::invalid_argument("invalid Schema: empty key")); }
+    inline void schema_error_invalid_character_in_key() { ARGPARSE_THROW(std::invalid_argument("invalid Schema: invalid character in key")); }
+    inline void schema_error_duplicate_key() { ARGPARSE_THROW(std::invalid_argument("invalid Schema: duplicate key")); }
+    inline void schema_error_too_many_keys() { ARGPARSE_THROW(std::invalid_argument("invalid Schema: too many keys")); }
+
+    // Description of a single argument in a `Schema`, created through `positional` or `option`
+    struct SchemaSpec {
+        bool is_positional;
+        std::string_view keys;
+    };
+    constexpr SchemaSpec positional(std::string_view name) { return {true, name}; }
+    constexpr SchemaSpec option(std::string_view keys) { return {false, keys}; }
+
+    // Reference to an argument in a Schema, which is passed to `Args::arg`, `Args::kwarg` or `Args::flag`
+    struct SchemaKey {
+        const void *schema;
+        int (*find)(const void *schema, std::string_view key);    // type-erased `Schema::find`
+        size_t slot;
+        size_t n_slots;
+        SchemaSpec spec;
+    };
+
+    /* Compile-time alternative to passing the keys of each argument as a runtime string. All keys are validated, checked for duplicates and
+     * indexed when the Schema is constructed, which happens at compile time when it is declared `static constexpr`:
+     *
+     *   struct MyArgs : public argparse::Args {
+     *       static constexpr auto schema = argparse::make_schema(argparse::positional("src"), argparse::option("k,key"), argparse::option("v,verbose"));
+     *       std::string &src = arg(schema[0], "Source path");
+     *       int &k           = kwarg(schema[1], "A number");
+     *       bool &verbose    = flag(schema[2], "A flag to toggle verbose");
+     *   };
+     *
+     * Single-character keys are looked up in a direct table, longer keys in a perfect-size open-addressing table, both computed at compile time.
+     */
+    template <size_t N> class Schema {
+        static constexpr size_t n_long_slots = [] { size_t capacity = 4; while (capacity < 4 * N) capacity *= 2; return capacity; }();  // room for an average of 2 long keys per argument
+        static constexpr uint16_t none = 0xFFFF;
+        struct LongSlot {
+            std::string_view key;
+            uint16_t slot = none;
+        };
+
+        std::array<SchemaSpec, N> specs_{};
+        std::array<uint16_t, 256> short_slots_{};
+        std::array<LongSlot, n_long_slots> long_slots_{};
+        size_t n_positional_ = 0;
+
+        static constexpr bool is_valid_key_char(char c) {
+            return c != ',' && c != '=' && c != ' ' && c != '\t' && c != '\n' && c != '"' && c != '\'';
+        }
+
+    public:
+        constexpr explicit Schema(const std::array<SchemaSpec, N> &specs) : specs_(specs) {
+            static_assert(N < none, "Too many arguments in a single Schema");
+            for (auto &s : short_slots_)
+                s = none;
+            size_t n_long_keys = 0;
+            for (size_t i = 0; i < N; i++) {
+                if (specs_[i].is_positional) {
+                    n_positional_++;
+                    if (specs_[i].keys.empty())
+                        schema_error_empty_key();
+                    for (const char c : specs_[i].keys) {
+                        if (!is_valid_key_char(c))
+                            schema_error_invalid_character_in_key();
+                    }
+                    continue;
+                }
+                for (const std::string_view key : KeyList(specs_[i].keys)) {
+                    if (key.empty())
+                        schema_error_empty_key();
+                    if (key[0] == '-')
+                        schema_error_invalid_character_in_key();
+                    for (const char c : key) {
+                        if (!is_valid_key_char(c))
+                            schema_error_invalid_character_in_key();
+                    }
+                    if (find(key) >= 0)
+                        schema_error_duplicate_key();
+
+                    if (key.size() == 1) {
+                        short_slots_[(unsigned char)key[0]] = (uint16_t)i;
+                    } else {
+                        if (++n_long_keys * 2 > n_long_slots)
+                            schema_error_too_many_keys();
+                        size_t j = hash_key(key) & (n_long_slots - 1);
+                        while (long_slots_[j].slot != none)
+                            j = (j + 1) & (n_long_slots - 1);
+                        long_slots_[j] = LongSlot{key, (uint16_t)i};
+                    }
+                }
+            }
+        }
+
+        // Index of the argument with `key`, or -1 when it does not exist
+        [[nodiscard]] constexpr int find(std::string_view key) const {
+            if (key.size() == 1)
+                return short_slots_[(unsigned char)key[0]] == none ? -1 : short_slots_[(unsigned char)key[0]];
+            for (size_t j = hash_key(key) & (n_long_slots - 1); long_slots_[j].slot != none; j = (j + 1) & (n_long_slots - 1)) {
+                if (long_slots_[j].key == key)
+                    return long_slots_[j].slot;
+            }
+            return -1;
+        }
+
+        [[nodiscard]] constexpr size_t size() const { return N; }
+        [[nodiscard]] constexpr size_t n_positional() const { return n_positional_; }
+
+        [[nodiscard]] constexpr SchemaKey operator[](size_t i) const {
+            return SchemaKey{this, [](const void *schema, std::string_view key) { return ((const Schema *)schema)->find(key); }, i, N, specs_[i]};
+        }
+    };
+
+    template <typename... Specs> constexpr Schema<sizeof...(Specs)> make_schema(const Specs &...specs) {
+        return Schema<sizeof...(Specs)>(std::array<SchemaSpec, sizeof...(Specs)>{specs...});
+    }
+
+#ifdef ARGPARSE_ENABLE_STATS
+    /* Statistics of the last parse, to find out where the time of a parse is spent. Only available when ARGPARSE_ENABLE_STATS is defined,
+     * otherwise none of the bookkeeping is compiled in. Conversion time is excluded from the phase in which the conversion took place
+     */
+    struct ParseStats {
+        enum Phase { SUBCOMMAND_DISPATCH, TOKENIZE, KEY_LOOKUP, POSITIONAL_ASSIGNMENT, CONVERSION, APPLY_DEFAULTS, VALIDATE, N_PHASES };
+        static constexpr const char *phase_names[N_PHASES] = {"subcommand dispatch", "tokenize", "key lookup", "positional assignment", "conversion", "apply defaults", "validate"};
+        static constexpr size_t max_slowest = 8;
+        using clock = std::chrono::steady_clock;
+
+        struct Conversion {
+            std::string_view key;           // the keys of the entry, e.g. "n,number"
+            std::chrono::nanoseconds time{0};
+        };
+
+        std::array<std::chrono::nanoseconds, N_PHASES> phase_time{};
+        size_t n_conversions = 0;           // number of values converted from the commandline
+        size_t n_defaults = 0;              // number of default values applied
+        size_t bytes_allocated = 0;         // only measured when `allocation_probe` is set
+        std::array<Conversion, max_slowest> slowest{};  // the slowest conversions, slowest first
+        size_t n_slowest = 0;
+
+        // Optional function returning the total number of bytes allocated so far, e.g. counted in a replaced operator new
+        static inline size_t (*allocation_probe)() = nullptr;
+
+        [[nodiscard]] std::chrono::nanoseconds total() const {
+            std::chrono::nanoseconds sum{0};
+            for (const auto &t : phase_time)
+                sum += t;
+            return sum;
+        }
+
+        void print(std::ostream &os = cout) const {
+            for (size_t p = 0; p < N_PHASES; p++)
+                os << setw(24) << phase_names[p] << " : " << std::chrono::duration<double, std::micro>(phase_time[p]).count() << " us" << endl;
+            os << setw(24) << "conversions" << " : " << n_conversions << endl;
+            os << setw(24) << "defaults" << " : " << n_defaults << endl;
+            if (allocation_probe != nullptr)
+                os << setw(24) << "bytes allocated" << " : " << bytes_allocated << endl;
+            for (size_t i = 0; i < n_slowest; i++)
+                os << setw(24) << slowest[i].key << " : " << std::chrono::duration<double, std::micro>(slowest[i].time).count() << " us" << endl;
+        }
+
+    private:
+        friend class Args;
+        clock::time_point lap_start_;
+        size_t bytes_start_ = 0;
+
+        void _start() {
+            *this = ParseStats();
+            bytes_start_ = allocation_probe != nullptr ? allocation_probe() : 0;
+            lap_start_ = clock::now();
+        }
+
+        // Attribute the time since the previous lap to `phase`
+        void _lap(Phase phase) {
+            const clock::time_point now = clock::now();
+            phase_time[phase] += now - lap_start_;
+            lap_start_ = now;
+        }
+
+        void _finish() {
+            if (allocation_probe != nullptr)
+                bytes_allocated = allocation_probe() - bytes_start_;
+        }
+
+        // Time the conversion in `f`, and exclude it from the phase in which it happens
+        template <typename F> void _convert(std::string_view key, F &&f) {
+            const clock::time_point start = clock::now();
+            f();
+            const std::chrono::nanoseconds time = clock::now() - start;
+            phase_time[CONVERSION] += time;
+            lap_start_ += time;
+            n_conversions++;
+
+            size_t i = std::min(n_slowest, max_slowest - 1);
+            if (n_slowest == max_slowest && time <= slowest[i].time)
+                return;
+            for (; i > 0 && slowest[i - 1].time < time; i--)    // insertion into the sorted list of slowest conversions
+                slowest[i] = slowest[i - 1];
+            slowest[i] = {key, time};
+            n_slowest = std::min(n_slowest + 1, max_slowest);
+        }
+    };
+#define ARGPARSE_STATS(...) __VA_ARGS__
+#else
+#define ARGPARSE_STATS(...)
+#endif
+
+    // A conversion of an independent entry, which is deferred until all arguments have been found, see `Entry::independent`
+    struct PendingConversion {
+        Entry *entry;
+        std::string_view value;
+        const std::string_view *values = nullptr;   // the tokens of a multi-argument, or nullptr for a single value
+        size_t n = 0;
+    };
+
+    class Args {
+    private:
+        std::pmr::memory_resource *resource_ = std::pmr::get_default_resource();  // all allocations of the parser come from this resource
+        size_t _arg_idx = 0;
+        Tokens tokens_{resource_};
+        std::pmr::vector<std::shared_ptr<Entry>> all_entries{resource_};
+        KeyIndex<Entry> kwarg_entries{resource_};               // frozen index of all keyworded entries, built by `_build_index`
+        KeyIndex<SubcommandEntry> subcommand_index{resource_};  // frozen index of all subcommands, built by `_build_index`
+        bool index_outdated = true;
+        std::pmr::vector<std::shared_ptr<Entry>> arg_entries{resource_};
+        std::pmr::map<std::pmr::string, std::shared_ptr<SubcommandEntry>> subcommand_entries{resource_};
+        std::pmr::vector<std::string_view> arguments_flat{resource_};   // scratch buffer for the positional arguments, kept to be reused by `reparse`
+        bool *help_flag = nullptr;
+        const void *schema = nullptr;               // the compile-time Schema used by this object, if any
+        int (*schema_find)(const void *schema, std::string_view key) = nullptr;
+        std::pmr::vector<Entry*> schema_entries{resource_};     // the entry of each argument in `schema`
+        std::pmr::vector<PendingConversion> pending_{resource_};   // conversions of independent entries, run at the end of `_parse`
+        ParseResult result_{std::pmr::vector<ParseError>(resource_)};   // the errors of the last parse
+        ARGPARSE_STATS(ParseStats stats_;)
+        friend class ParsedArgs;
+        friend class FrozenArgs;
+        bool has_options() {
+            return std::find_if(all_entries.begin(), all_entries.end(), [](auto e) { return e->type != Entry::ARG; }) != all_entries.end();
+        };
+
+        bool has_key(std::string_view key) const {
+            for (const auto &entry : all_entries) {
+                if (entry->type != Entry::ARG && std::find(entry->keys_.begin(), entry->keys_.end(), key) != entry->keys_.end())
+                    return true;
             }
-            return *this;
+            return false;
         }
 
-        Entry &multi_argument() {
-            _is_multi_argument = true;
-            return *this;
+        // Convert a value of `entry` through `f`, which is timed when ARGPARSE_ENABLE_STATS is defined
+        template <typename F> void _convert(Entry *entry, F &&f) {
+#ifdef ARGPARSE_ENABLE_STATS
+            stats_._convert(entry->keys_.str(), f);
+#else
+            (void)entry;
+            f();
+#endif
         }
 
-        // Magically convert the value string to the requested type
-        template <typename T> operator T&() {
-            // Automatically set the default to nullptr for pointer types and empty for optional types
-            if constexpr (is_optional<T>::value || std::is_pointer<T>::value || is_shared_ptr<T>::value) {
-                if (!default_str_.has_value()) {
-                    default_str_ = "none";
-                    if constexpr(is_optional<T>::value) {
-                        data_default = std::make_unique<ConvertType<T>> (T{std::nullopt});
-                    } else {
-                        data_default = std::make_unique<ConvertType<T>> ((T) nullptr);
-                    }
-                }
+        // Receives the values found by `_scan` and `_assign_positionals`, and converts them into the entries
+        struct ConvertSink {
+            Args &args;
+            std::pmr::vector<ParseError> &errors;
+
+            void value(Entry *entry, std::string_view v) {
+                if (entry->independent_)
+                    args._defer({entry, v});
+                else
+                    args._convert(entry, [&] { entry->_convert(v); });
+            }
+            void values(Entry *entry, const std::string_view *v, size_t n) {
+                if (entry->independent_)
+                    args._defer({entry, std::string_view(), v, n});
+                else
+                    args._convert(entry, [&] { entry->_convert_multi(v, n); });
             }
+            void missing_value(Entry *entry, std::string_view key) { entry->_set_error(ErrorCode::MISSING_VALUE, key); }
+            void unrecognised(std::string_view key) { errors.push_back({ErrorCode::UNRECOGNISED_ARGUMENT, key, std::string_view(), nullptr, {}}); }
+        };
 
-            datap = std::make_unique<ConvertType<T>>();
-            return ((ConvertType<T>*)(datap.get()))->data;
+        void _defer(const PendingConversion &conversion) {
+            conversion.entry->value_ = conversion.value;    // marks the entry as set, so that its default is not applied
+            pending_.push_back(conversion);
         }
 
-        // Force an ambiguous error when not using a reference.
-        template <typename T> operator T() {} // When you get here  because you received an error, make sure all parameters of argparse are references (e.g. with `&`)
-
-    private:
-        std::vector<std::string> keys_;
-        std::string help;
-        std::optional<std::string> value_;
-        std::optional<std::string> implicit_value_;
-        std::optional<std::string> default_str_;
-        std::string error;
-        std::unique_ptr<ConvertBase> datap;
-        std::unique_ptr<ConvertBase> data_default;
-        bool _is_multi_argument = false;
-        bool is_set_by_user = true;
+        /* Run the deferred conversions, where the entries are converted concurrently and the conversions of the same entry run in order on one thread.
+         * Every entry gets its own thread, since such conversions are often waiting for I/O. Errors are stored in the entries, which are still
+         * reported in order of declaration. Values that allocate from a memory resource other than new_delete_resource are converted one by one
+         */
+        void _convert_pending() {
+            if (pending_.empty())
+                return;
+            std::stable_sort(pending_.begin(), pending_.end(), [](const PendingConversion &a, const PendingConversion &b) { return a.entry->index_ < b.entry->index_; });
+            std::pmr::vector<size_t> starts(resource_);     // the first conversion of every entry
+            for (size_t i = 0; i < pending_.size(); i++) {
+                if (i == 0 || pending_[i].entry != pending_[i - 1].entry)
+                    starts.push_back(i);
+            }
+            starts.push_back(pending_.size());
+
+            const size_t n_entries = starts.size() - 1;
+            parallel_for(n_entries, [&](size_t k) {
+                for (size_t i = starts[k]; i < starts[k + 1]; i++) {
+                    const PendingConversion &conversion = pending_[i];
+                    if (conversion.values != nullptr)
+                        conversion.entry->_convert_multi(conversion.values, conversion.n);
+                    else
+                        conversion.entry->_convert(conversion.value);
+                }
+            }, resource_ == std::pmr::new_delete_resource() ? n_entries : 1);
+            pending_.clear();
+        }
 
-        [[nodiscard]] std::string _get_keys() const {
-            std::stringstream ss;
-            for (size_t i = 0; i < keys_.size(); i++)
-                ss << (i? "," : "") << (type == ARG? "" : (keys_[i].size() > 1 ? "--" : "-")) + keys_[i];
-            return ss.str();
+        Entry *_find_kwarg(std::string_view key) const {
+            if (schema_find != nullptr) {   // keys of a compile-time schema take precedence over keys added at runtime
+                const int slot = schema_find(schema, key);
+                if (slot >= 0 && schema_entries[slot] != nullptr)
+                    return schema_entries[slot];
+            }
+            return kwarg_entries.find(key);
         }
 
-        void _convert(const std::string &value) {
-            try {
-                this->value_ = value;
-                datap->convert(value);
-            } catch (const std::invalid_argument &e) {
-                error = "Invalid argument, could not convert \"" + value + "\" for " + _get_keys() + " (" + help + ")";
-            } catch (const std::runtime_error &e) {
-                error = "Invalid argument \"" + value + "\" for " + _get_keys() + " (" + help + "). Error: " + e.what();
+        // Find a keyworded entry by any of its keys, or a positional entry by its name
+        const Entry *_find_entry(std::string_view key) const {
+            if (const Entry *entry = _find_kwarg(key))
+                return entry;
+            for (const auto &entry : arg_entries) {
+                if (entry->keys_.str() == key)
+                    return entry.get();
             }
+            return nullptr;
         }
 
-        void _apply_default() {
-            is_set_by_user = false;
-            if (data_default != nullptr) {
-                value_ = *default_str_; // for printing
-                datap->set_default(data_default, *default_str_);
-            } else if (default_str_.has_value()) {   // in cases where a string is provided to the `set_default` function
-                _convert(default_str_.value());
+        template <typename Key> std::shared_ptr<Entry> _make_entry(Entry::ARG_TYPE type, const Key &key, std::string_view help, const std::optional<std::string> &implicit_value) {
+            std::shared_ptr<Entry> entry = std::allocate_shared<Entry>(std::pmr::polymorphic_allocator<Entry>(resource_), type, key, help, implicit_value, resource_);
+            entry->index_ = all_entries.size();     // every new entry is appended to all_entries
+            return entry;
+        }
+
+        Entry &_add_schema_entry(const SchemaKey &key, Entry::ARG_TYPE type, const std::string &help, const std::optional<std::string> &implicit_value) {
+            if (key.spec.is_positional != (type == Entry::ARG))  // an option passed to `arg`, or a positional to `kwarg`, could never be reached
+                ARGPARSE_THROW(std::invalid_argument(std::string(key.spec.is_positional ? "positional '" : "option '") + std::string(key.spec.keys)
+                                                     + "' of the Schema must be added with " + (key.spec.is_positional ? "arg()" : "kwarg() or flag()")));
+            if (schema == nullptr) {    // reserve for all arguments at once, the layout is known from the schema
+                schema = key.schema;
+                schema_find = key.find;
+                schema_entries.assign(key.n_slots, nullptr);
+                all_entries.reserve(all_entries.size() + key.n_slots);
+            }
+            std::shared_ptr<Entry> entry = _make_entry(type, KeyList(key.spec.keys), help, implicit_value);
+            all_entries.emplace_back(entry);
+            if (type == Entry::ARG) {
+                _arg_idx++;
+                arg_entries.emplace_back(entry);
+            } else if (key.schema == schema) {
+                schema_entries[key.slot] = entry.get();
             } else {
-                error = "Argument missing: " + _get_keys() + " (" + help + ")";
+                entry->from_schema_ = false;  // arguments of a different schema are indexed at runtime
+                index_outdated = true;
             }
+            return *entry;
         }
 
-        [[nodiscard]] std::string info() const {
-            const std::string allowed_entries = datap->get_allowed_entries();
-            const std::string default_value = default_str_.has_value() ? "default: " + *default_str_ : "required";
-            const std::string implicit_value = implicit_value_.has_value() ? "implicit: \"" + *implicit_value_ + "\", ": "";
-            const std::string allowed_value = !allowed_entries.empty()? "allowed: <" + allowed_entries.substr(0, allowed_entries.size()-2) + ">, ": "";
-            return " [" + allowed_value + implicit_value + default_value + "]";
+        // Freeze all registered keys into the lookup index, this only needs to happen once after the last kwarg is registered
+        void _build_index() {
+            size_t n_long_keys = 0;
+            for (const auto &entry : all_entries) {
+                if (entry->type != Entry::ARG && !entry->from_schema_)
+                    n_long_keys += std::count_if(entry->keys_.begin(), entry->keys_.end(), [](std::string_view k) { return k.size() != 1; });
+            }
+            kwarg_entries.clear(n_long_keys);
+            for (const auto &entry : all_entries) {
+                if (entry->type != Entry::ARG && !entry->from_schema_) {
+                    for (std::string_view k : entry->keys_)
+                        kwarg_entries.insert(k, entry.get());
+                }
+            }
+            subcommand_index.clear(subcommand_entries.size());
+            for (const auto &[subcommand, subentry] : subcommand_entries)
+                subcommand_index.insert(subcommand, subentry.get());
+            index_outdated = false;
         }
 
-        friend class Args;
-    };
+        /* Add the help flag and build the key index, after which the schema is not modified by parsing anymore. With `subcommands`,
+         * all subcommands are constructed and frozen as well, such that a const parser can be shared between threads
+         */
+        void _freeze(bool subcommands) {
+            if (help_flag == nullptr)
+                help_flag = &(bool&)flag(has_key("h") ? "?,help" : "?,h,help", "print help");
+            if (index_outdated)
+                _build_index();
+            if (subcommands) {
+                for (const auto &[subcommand, subentry] : subcommand_entries)
+                    subentry->get()._freeze(true);
+            }
+        }
 
-    struct SubcommandEntry {
-        std::shared_ptr<Args> subargs;
-        std::string subcommand_name;
+        /* Find the subcommand among the positional arguments, skipping the values that are consumed by options (e.g. `-m commit`).
+         * Without multi-valued positional entries, the search stops after the positional arguments that can belong to this parser, i.e. it only looks at
+         * the first one when there are no positional entries. Returns the index of the subcommand in params, or params.size() when no subcommand was given
+         */
+        size_t _find_subcommand(const Tokens &tokens) const {
+            const std::pmr::vector<std::string_view> &params = tokens.params;
+            const bool bounded = std::none_of(arg_entries.begin(), arg_entries.end(), [](const auto &entry) { return entry->_is_multi_argument; });
+            size_t n_positional = 0;
+            for (size_t i = 0; i < params.size(); i++) {
+                if (tokens.is_value(i)) {
+                    if (subcommand_index.find(params[i]) != nullptr)
+                        return i;
+                    if (++n_positional > arg_entries.size() && bounded)
+                        break;
+                    continue;
+                }
+                const std::string_view param = params[i];
+                if (param.size() < 2 || param.find('=') != std::string_view::npos)
+                    continue;
+                const Entry *entry = _find_kwarg(param[1] == '-' ? param.substr(2) : param.substr(param.size() - 1));  // only the last key of a short group (-abc) takes a value
+                if (entry == nullptr || entry->implicit_value_.has_value())
+                    continue;
+                if (entry->_is_multi_argument) {
+                    while (tokens.is_value(i + 1))
+                        i++;
+                } else if (tokens.is_value(i + 1)) {
+                    i++;
+                }
+            }
+            return params.size();
+        }
 
-        explicit SubcommandEntry(std::string subcommand_name) : subcommand_name(std::move(subcommand_name)) {}
+        // Name of the program from its path, e.g. "/usr/bin/app.exe" -> "app"
+        static std::string_view _program_name(std::string_view program) {
+#ifdef _WIN32
+            program.remove_prefix(std::min(program.size(), program.find_last_of("/\\") + 1));
+#else
+            program.remove_prefix(std::min(program.size(), program.find_last_of('/') + 1));
+#endif
+            if (program != ".." && program.rfind('.') != 0 && program.rfind('.') != std::string_view::npos)
+                program = program.substr(0, program.rfind('.'));
+            return program;
+        }
 
-        template<typename T> operator T &() {
-            static_assert(std::is_base_of_v<Args, T>, "Subcommand type must be a derivative of argparse::Args");
+        /* Match the options in `tokens` with their entries, and collect the positional arguments in `flat`. The values that are found are passed to `sink`,
+         * which either converts them into the entries, or records them in a ParsedArgs
+         */
+        template <typename Sink> void _scan(const Tokens &tokens, std::pmr::vector<std::string_view> &flat, Sink &sink) const {
+            const std::pmr::vector<std::string_view> &params = tokens.params;
+            auto parse_param = [&](size_t &i, std::string_view key, const bool is_short, const std::optional<std::string_view> &equal_value=std::nullopt) {
+                Entry *entry = _find_kwarg(key);
+                if (entry != nullptr) {
+                    if (equal_value.has_value()) {
+                        sink.value(entry, equal_value.value());
+                    } else if (entry->implicit_value_.has_value()) {
+                        sink.value(entry, *entry->implicit_value_);
+                    } else if (!is_short) { // short values are not allowed to look ahead for the next parameter
+                        if (entry->_is_multi_argument) {    // pass all following values token by token, or an empty vector when there are none
+                            const size_t first = i + 1;
+                            while (tokens.is_value(i + 1))
+                                i++;
+                            sink.values(entry, params.data() + first, i + 1 - first);
+                        } else if (tokens.is_value(i + 1)) {
+                            i++;
+                            sink.value(entry, params[i]);
+                        } else {
+                            sink.missing_value(entry, key);
+                        }
+                    } else {
+                        sink.missing_value(entry, key);
+                    }
+                } else {
+                    sink.unrecognised(key);
+                }
+            };
+            auto add_param = [&](size_t &i, const size_t &start) {
+                const std::string_view param = params[i];
+                size_t eq_idx = param.find('=');  // check if value was passed using the '=' sign
+                if (eq_idx != std::string_view::npos) { // key/value from = notation
+                    parse_param(i, param.substr(start, eq_idx - start), false, param.substr(eq_idx + 1));
+                } else {
+                    parse_param(i, param.substr(start), false);
+                }
+            };
 
-            std::shared_ptr<T> res = std::make_shared<T>();
-            res->program_name = subcommand_name;
-            subargs = res;
-            return *(T*)(subargs.get());
+            flat.clear();
+            for (size_t i = 0; i < params.size(); i++) {
+                if (!tokens.is_value(i)) {
+                    if (params[i].size() > 1 && params[i][1] == '-') {  // long --
+                        add_param(i, 2);
+                    } else { // short -
+                        const size_t j_end = std::min(params[i].size(), params[i].find('=')) - 1;
+                        for (size_t j = 1; j < j_end; j++) { // add possible other flags
+                            parse_param(i, params[i].substr(j, 1), true);
+                        }
+                        add_param(i, j_end);
+                    }
+                } else {
+                    flat.emplace_back(params[i]);
+                }
+            }
         }
 
-        // Force an ambiguous error when not using a reference.
-        template <typename T> operator T() {} // When you get here  because you received an error, make sure all parameters of argparse are references (e.g. with `&`)
-    };
+        // Pass the positional arguments to `sink`, making sure multi_argument positional arguments are processed last to enable arguments afterwards
+        template <typename Sink> void _assign_positionals(const std::pmr::vector<std::string_view> &flat, Sink &sink) const {
+            size_t arg_i = 0;
+            for (; arg_i < arg_entries.size() && !arg_entries[arg_i]->_is_multi_argument; arg_i++) { // iterate over positional arguments until a multi-argument is found
+                if (arg_i < flat.size())
+                    sink.value(arg_entries[arg_i].get(), flat[arg_i]);
+            }
+            size_t arg_j = 1;
+            for (size_t j_end = arg_entries.size() - arg_i; arg_j <= j_end; arg_j++) { // iterate from back to front, to ensure non-multi-arguments in the front and back are given preference
+                size_t flat_idx = flat.size() - arg_j;
+                if (flat_idx < flat.size() && flat_idx >= arg_i) {
+                    if (arg_entries[arg_entries.size() - arg_j]->_is_multi_argument) {
+                        sink.values(arg_entries[arg_i].get(), flat.data() + arg_i, flat_idx + 1 - arg_i);  // pass all remaining arguments token by token
+                    } else {
+                        sink.value(arg_entries[arg_entries.size() - arg_j].get(), flat[flat_idx]);
+                    }
+                }
+            }
+        }
 
-    class Args {
-    private:
-        size_t _arg_idx = 0;
-        std::vector<std::string> params;
-        std::vector<std::shared_ptr<Entry>> all_entries;
-        std::map<std::string, std::shared_ptr<Entry>> kwarg_entries;
-        std::vector<std::shared_ptr<Entry>> arg_entries;
-        std::map<std::string, std::shared_ptr<SubcommandEntry>> subcommand_entries;
-        bool has_options() {
-            return std::find_if(all_entries.begin(), all_entries.end(), [](auto e) { return e->type != Entry::ARG; }) != all_entries.end();
-        };
+        // Parse the tokens of a ParsedArgs without modifying this parser, see FrozenArgs
+        void _parse_frozen(ParsedArgs &out, std::pmr::vector<ParseError> &errors) const;
 
     public:
-        std::string program_name;
+        std::string program_name;   // a plain std::string that is not allocated from the memory resource, which fits inline for most names
         bool is_valid = false;
 
+#ifdef ARGPARSE_ENABLE_STATS
+        // Statistics of the last parse, the time spent in a subcommand is attributed to the subcommand dispatch of its parent
+        [[nodiscard]] const ParseStats &stats() const { return stats_; }
+#endif
+
+        Args() = default;
+
+        /* Allocate all entries, keys, converted values and buffers of the parser from `resource`, e.g. an std::pmr::monotonic_buffer_resource.
+         * Fields of allocator-aware types such as std::pmr::vector and std::pmr::string are allocated from it as well, and subcommands that
+         * have a constructor taking a memory resource receive it too. The resource must outlive this object
+         */
+        explicit Args(std::pmr::memory_resource *resource) : resource_(resource) {}
+
         virtual ~Args() = default;
 
+        [[nodiscard]] std::pmr::memory_resource *resource() const { return resource_; }
+
         /* Add a positional argument, the order in which it is defined equals the order in which they are being read.
          * help : Description of the variable
          *
@@ -376,7 +2795,7 @@ namespace argparse {
          * Returns a reference to the Entry, which will collapse into the requested type in `Entry::operator T()`
          */
         Entry &arg(const std::string& key, const std::string &help) {
-            std::shared_ptr<Entry> entry = std::make_shared<Entry>(Entry::ARG, key, help);
+            std::shared_ptr<Entry> entry = _make_entry(Entry::ARG, std::string_view(key), help, std::nullopt);
             // Increasing _arg_idx, so that arg2 will be arg_2, irregardless of whether it is preceded by other positional arguments
             _arg_idx++;
             arg_entries.emplace_back(entry);
@@ -392,11 +2811,9 @@ namespace argparse {
          * Returns a reference to the Entry, which will collapse into the requested type in `Entry::operator T()`
          */
         Entry &kwarg(const std::string &key, const std::string &help, const std::optional<std::string>& implicit_value=std::nullopt) {
-            std::shared_ptr<Entry> entry = std::make_shared<Entry>(Entry::KWARG, key, help, implicit_value);
+            std::shared_ptr<Entry> entry = _make_entry(Entry::KWARG, std::string_view(key), help, implicit_value);
             all_entries.emplace_back(entry);
-            for (const std::string &k : entry->keys_) {
-                kwarg_entries[k] = entry;
-            }
+            index_outdated = true;
             return *entry;
         }
 
@@ -410,15 +2827,29 @@ namespace argparse {
             return kwarg(key, help, "true").set_default<bool>(false);
         }
 
+        // Counterparts of `arg`, `kwarg` and `flag` for arguments declared in a compile-time `Schema`, see `Schema` for an example
+        Entry &arg(const SchemaKey &key, const std::string &help) {
+            return _add_schema_entry(key, Entry::ARG, help, std::nullopt);
+        }
+
+        Entry &kwarg(const SchemaKey &key, const std::string &help, const std::optional<std::string>& implicit_value=std::nullopt) {
+            return _add_schema_entry(key, Entry::KWARG, help, implicit_value);
+        }
+
+        Entry &flag(const SchemaKey &key, const std::string &help) {
+            return kwarg(key, help, "true").set_default<bool>(false);
+        }
+
         /* Add a a subcommand
          * command : name of the subcommand, e.g. 'commit', if you wish to implement a function like 'git commit'
          *
-         * Returns a reference to the Entry, which will collapse into the requested type in `Entry::operator T()`
-         * Expected type *Must* be an std::shared_ptr of derivative of the argparse::Args class
+         * Returns a reference to the SubcommandEntry, which will collapse into the requested type in `SubcommandEntry::operator T&()`
+         * Expected type *Must* be a derivative of the argparse::Args class, or an std::shared_ptr of it to construct the subcommand only when it is selected
          */
         SubcommandEntry &subcommand(const std::string &command) {
-            std::shared_ptr<SubcommandEntry> entry = std::make_shared<SubcommandEntry>(command);
-            subcommand_entries[command] = entry;
+            std::shared_ptr<SubcommandEntry> entry = std::allocate_shared<SubcommandEntry>(std::pmr::polymorphic_allocator<SubcommandEntry>(resource_), command, resource_);
+            subcommand_entries[std::pmr::string(command, resource_)] = entry;
+            index_outdated = true;
             return *entry;
         }
 
@@ -449,18 +2880,18 @@ namespace argparse {
             }
 
             for (const auto &[subcommand, subentry] : subcommand_entries) {
-                cout << endl << endl << bold("Subcommand: ") << bold(subcommand) << endl;
-                subentry->subargs->help();
+                cout << endl << endl << bold("Subcommand: ") << bold(std::string(subcommand)) << endl;
+                subentry->get().help();
             }
         }
 
         void validate(const bool &raise_on_error) {
             for (const auto &entry : all_entries) {
-                if (!entry->error.empty()) {
+                if (entry->error_code_ != ErrorCode::NONE) {
                     if (raise_on_error) {
-                        throw std::runtime_error(entry->error);
+                        ARGPARSE_THROW(std::runtime_error(entry->_error_message()));
                     } else {
-                        std::cerr << entry->error << std::endl;
+                        std::cerr << entry->_error_message() << std::endl;
                         exit(-1);
                     }
                 }
@@ -471,135 +2902,150 @@ namespace argparse {
          * Upon error, it will print the error and exit immediately if validation_action is ValidationAction::EXIT_ON_ERROR
          */
         void parse(int argc, const char* const *argv, const bool &raise_on_error) {
-            auto parse_subcommands = [&]() -> int {
-                for (int i = 1; i < argc; i++) {
-                    for (auto &[subcommand, subentry] : subcommand_entries) {
-                        if (subcommand == argv[i]) {
-                            subentry->subargs->parse(argc - i, argv + i, raise_on_error);
-                            return i;
-                        }
-                    }
-                }
-                return argc;
-            };
-            argc = parse_subcommands();   // argc_ is the number of arguments that should be parsed after the subcommand has finished parsing
+            _tokenize(argc, argv);
+            _parse(result_.errors, true);
+            _release_scratch();
+            _report(raise_on_error);
+        }
 
-            program_name = std::filesystem::path(argv[0]).stem().string();
-            params = std::vector<std::string>(argv + 1, argv + argc);
+        /* Parse without throwing or exiting, where all errors are collected in the returned result. Their messages are only built when requested, and
+         * --help only sets the help flag instead of printing the help. The result refers to the parsed commandline, and remains valid until the next parse
+         */
+        const ParseResult &try_parse(int argc, const char* const *argv) {
+            _tokenize(argc, argv);
+            _parse(result_.errors, false);
+            return result_;
+        }
 
-            std::string help_keys = kwarg_entries.count("h") ? "?,help" : "?,h,help";
-            bool& _help = flag(help_keys, "print help");
+        /* Parse a new commandline into this object, reusing the entries, buffers and key index of previous parses. Fields are updated in place,
+         * so references to them remain valid. After the first parse, this will not allocate for scalar fields (e.g. numbers, flags and enums)
+         */
+        void reparse(int argc, const char* const *argv, const bool &raise_on_error=false) {
+            _tokenize(argc, argv);
+            _parse(result_.errors, true);
+            _report(raise_on_error);
+        }
 
-            auto is_value = [&](const size_t &i) -> bool {
-                return params.size() > i && (params[i][0] != '-' || (params[i].size() > 1 && std::isdigit(params[i][1])));  // check for number to not accidentally mark negative numbers as non-parameter
-            };
-            auto parse_param = [&](size_t &i, const std::string &key, const bool is_short, const std::optional<std::string> &equal_value=std::nullopt) {
-                auto itt = kwarg_entries.find(key);
-                if (itt != kwarg_entries.end()) {
-                    auto &entry = itt->second;
-                    if (equal_value.has_value()) {
-                        entry->_convert(equal_value.value());
-                    } else if (entry->implicit_value_.has_value()) {
-                        entry->_convert(*entry->implicit_value_);
-                    } else if (!is_short) { // short values are not allowed to look ahead for the next parameter
-                        if (is_value(i + 1)) {
-                            std::string value = params[++i];
-                            if (entry->_is_multi_argument) {
-                                while (is_value(i + 1))
-                                    value += "," + params[++i];
-                            }
-                            entry->_convert(value);
-                        } else if (entry->_is_multi_argument) {
-                            entry->_convert("");    // for multiargument parameters, return an empty vector when not passing any more values
-                        } else {
-                            entry->error = "No value provided for: " + key;
-                        }
-                    } else {
-                        entry->error = "No value provided for: " + key;
-                    }
-                } else {
-                    if (raise_on_error)
-                        throw std::runtime_error("unrecognised commandline argument :  " + key);
-                    else
-                        cerr << "unrecognised commandline argument :  " << key << endl;
-                }
-            };
-            auto add_param = [&](size_t &i, const size_t &start) {
-                size_t eq_idx = params[i].find('=');  // check if value was passed using the '=' sign
-                if (eq_idx != std::string::npos) { // key/value from = notation
-                    std::string key = params[i].substr(start, eq_idx - start);
-                    std::string value = params[i].substr(eq_idx + 1);
-                    parse_param(i, key, false, value);
-                } else {
-                    std::string key = std::string(params[i].substr(start));
-                    parse_param(i, key, false);
-                }
-            };
+        // Forget the result of the previous parse, including the subcommands
+        void reset() {
+            is_valid = false;
+            tokens_.clear();
+            result_.errors.clear();
+            for (const auto &entry : all_entries)
+                entry->_reset();
+            for (const auto &[subcommand, subentry] : subcommand_entries)
+                if (subentry->subargs != nullptr)
+                    subentry->subargs->reset();
+        }
 
-            std::vector<std::string> arguments_flat;
-            for (size_t i = 0; i < params.size(); i++) {
-                if (!is_value(i)) {
-                    if (params[i].size() > 1 && params[i][1] == '-') {  // long --
-                        add_param(i, 2);
-                    } else { // short -
-                        const size_t j_end = std::min(params[i].size(), params[i].find('=')) - 1;
-                        for (size_t j = 1; j < j_end; j++) { // add possible other flags
-                            const std::string key = std::string(1, params[i][j]);
-                            parse_param(i, key, true);
-                        }
-                        add_param(i, j_end);
-                    }
+    private:
+        void _report(const bool raise_on_error) const {
+            for (const ParseError &error : result_.errors) {
+                if (raise_on_error) {
+                    ARGPARSE_THROW(std::runtime_error(error.message()));
                 } else {
-                    arguments_flat.emplace_back(params[i]);
+                    std::cerr << error.message() << std::endl;
+                    if (error.code != ErrorCode::UNRECOGNISED_ARGUMENT)     // unrecognised arguments are ignored
+                        exit(-1);
                 }
             }
+        }
 
-            // Parse all the positional arguments, making sure multi_argument positional arguments are processed last to enable arguments afterwards
-            size_t arg_i = 0;
-            for (; arg_i < arg_entries.size() && !arg_entries[arg_i]->_is_multi_argument; arg_i++) { // iterate over positional arguments until a multi-argument is found
-                if (arg_i < arguments_flat.size())
-                    arg_entries[arg_i]->_convert(arguments_flat[arg_i]);
+        /* Release the buffers of the tokens and positional arguments, which `reparse` keeps to reuse them. The response files remain open,
+         * since the values of the entries may refer to their contents
+         */
+        void _release_scratch() {
+            if (std::none_of(all_entries.begin(), all_entries.end(), [](const auto &entry) { return entry->keeps_tokens_; })) {   // a lazy_list refers to the tokens
+                std::pmr::vector<std::string_view>(resource_).swap(tokens_.params);
+                std::pmr::vector<std::string_view>(resource_).swap(arguments_flat);
             }
-            size_t arg_j = 1;
-            for (size_t j_end = arg_entries.size() - arg_i; arg_j <= j_end; arg_j++) { // iterate from back to front, to ensure non-multi-arguments in the front and back are given preference
-                size_t flat_idx = arguments_flat.size() - arg_j;
-                if (flat_idx < arguments_flat.size() && flat_idx >= arg_i) {
-                    if (arg_entries[arg_entries.size() - arg_j]->_is_multi_argument) {
-                        std::stringstream s;  // Combine multiple arguments into 1 comma-separated string for parsing
-                        copy(&arguments_flat[arg_i],&arguments_flat[flat_idx] + 1, std::ostream_iterator<std::string>(s,","));
-                        std::string value = s.str();
-                        value.back() = '\0'; // remove trailing ','
-                        arg_entries[arg_i]->_convert(value);
-                    } else {
-                        arg_entries[arg_entries.size() - arg_j]->_convert(arguments_flat[flat_idx]);
-                    }
+            for (const auto &[subcommand, subentry] : subcommand_entries)
+                if (subentry->subargs != nullptr)
+                    subentry->subargs->_release_scratch();
+        }
+
+        void _tokenize(int argc, const char* const *argv) {
+            reset();
+            ARGPARSE_STATS(stats_._start());
+            program_name = _program_name(argv[0]);
+            for (int i = 1; i < argc; i++)
+                tokens_.add(argv[i], result_.errors);
+            ARGPARSE_STATS(stats_._lap(ParseStats::TOKENIZE));
+        }
+
+        /* Parse the arguments in tokens_, which may be handed over to a subcommand. All errors are appended to `errors`, including those of the subcommand.
+         * When `handle_help` is set, the help is printed and the program exits if the help flag is given
+         */
+        void _parse(std::pmr::vector<ParseError> &errors, const bool handle_help) {
+            _freeze(false);
+
+            if (!subcommand_entries.empty()) {
+                const size_t i = _find_subcommand(tokens_);
+                if (i < tokens_.params.size()) {
+                    SubcommandEntry &subentry = *subcommand_index.find(tokens_.params[i]);
+                    Args &subargs = subentry.get();
+                    subargs.program_name = subentry.subcommand_name;
+                    subargs.tokens_.params.assign(tokens_.params.begin() + i + 1, tokens_.params.end());
+                    subargs.tokens_.files = tokens_.files;
+                    ARGPARSE_STATS(subargs.stats_._start());
+                    subargs._parse(errors, handle_help);
+                    tokens_.params.resize(i);   // the arguments up to the subcommand are parsed by this parser
                 }
             }
+            ARGPARSE_STATS(stats_._lap(ParseStats::SUBCOMMAND_DISPATCH));
+            const size_t n_errors = errors.size();  // the errors of this parser follow those of the subcommand
+
+            ConvertSink sink{*this, errors};
+            _scan(tokens_, arguments_flat, sink);
+            ARGPARSE_STATS(stats_._lap(ParseStats::KEY_LOOKUP));
+            _assign_positionals(arguments_flat, sink);
+            ARGPARSE_STATS(stats_._lap(ParseStats::POSITIONAL_ASSIGNMENT));
 
             // try to apply default values for arguments which have not been set
             for (const auto &entry : all_entries) {
                 if (!entry->value_.has_value()) {
-                    entry->_apply_default();
+                    if (entry->independent_ && !entry->data_.has_default() && entry->default_str_.has_value()) {   // a default that is converted from its string
+                        _defer({entry.get(), *entry->default_str_});
+                        entry->is_set_by_user = false;
+                    } else {
+                        entry->_apply_default();
+                    }
+                    ARGPARSE_STATS(stats_.n_defaults += entry->_has_default());
                 }
             }
+            _convert_pending();
+            ARGPARSE_STATS(stats_._lap(ParseStats::APPLY_DEFAULTS));
 
-            if (_help) {
+            if (handle_help && *help_flag) {
                 help();
                 exit(0);
             }
 
-            validate(raise_on_error);
-            is_valid = true;
+            for (const auto &entry : all_entries) {
+                if (entry->error_code_ != ErrorCode::NONE)
+                    errors.push_back({entry->error_code_, entry->keys_.str(), entry->error_value_, entry.get(), entry->error});
+            }
+            ARGPARSE_STATS(stats_._lap(ParseStats::VALIDATE));
+            ARGPARSE_STATS(stats_._finish());
+            is_valid = errors.size() == n_errors;
+            if (is_valid) {
+                for (const auto &entry : all_entries) {
+                    if (entry->prefetch_ && entry->start_prefetch_ != nullptr)
+                        entry->start_prefetch_(entry->data_);
+                }
+            }
         }
 
+    public:
         void print() const {
             for (const auto &entry : all_entries) {
-                std::string snip = entry->type == Entry::ARG ? "(" + (entry->help.size() > 10 ? entry->help.substr(0, 7) + "..." : entry->help) + ")" : "";
-                cout << setw(21) << entry->_get_keys() + snip << " : " << (entry->is_set_by_user? bold(entry->value_.value_or("null")) : entry->value_.value_or("null")) << endl;
+                std::string snip = entry->type == Entry::ARG ? "(" + std::string(entry->help.size() > 10 ? entry->help.substr(0, 7) + "..." : entry->help) + ")" : "";
+                const std::string value = entry->value_from_data_ ? entry->data_.to_string() : std::string(entry->value_.value_or("null"));
+                cout << setw(21) << entry->_get_keys() + snip << " : " << (entry->is_set_by_user? bold(value) : value) << endl;
             }
 
             for (const auto &[subcommand, subentry] : subcommand_entries) {
-                if (subentry->subargs->is_valid) {
+                if (subentry->subargs != nullptr && subentry->subargs->is_valid) {
                     cout << endl << "--- Subcommand: " << subcommand << endl;
                     subentry->subargs->print();
                 }
@@ -609,7 +3055,7 @@ namespace argparse {
         virtual int run() {return 0;}       // For automatically running subcommands
         int run_subcommands() {
             for (const auto &[subcommand, subentry] : subcommand_entries) {
-                if (subentry->subargs->is_valid) {
+                if (subentry->subargs != nullptr && subentry->subargs->is_valid) {
                     return subentry->subargs->run();
                 }
             }
@@ -620,6 +3066,230 @@ namespace argparse {
         }
     };
 
+    inline Args &SubcommandEntry::get() {
+        if (subargs == nullptr && construct != nullptr) {
+            subargs = construct(*this);
+            subargs->program_name = subcommand_name;
+        }
+        return *subargs;
+    }
+
+    /* The result of parsing a commandline with a FrozenArgs, which holds the raw values of the arguments together with the values converted while parsing.
+     * It refers to the tokens it was parsed from and to the FrozenArgs, which both must outlive it
+     */
+    class ParsedArgs {
+    public:
+        std::string program_name;
+
+        explicit ParsedArgs(const Args *schema) : schema_(schema) {}
+
+        [[nodiscard]] bool ok() const { return errors_.empty(); }
+        explicit operator bool() const { return ok(); }
+
+        // All errors, with those of the subcommand first and those of arguments in order of declaration
+        [[nodiscard]] const std::pmr::vector<ParseError> &errors() const { return errors_; }
+
+        // Whether the argument was given on the commandline, rather than taking its default
+        [[nodiscard]] bool is_set(std::string_view key) const {
+            return values_[_entry(key).index_].raw.has_value();
+        }
+
+        /* The value of an argument converted to T, where `key` is any of the keys of an option or the name of a positional argument.
+         * A T of the declared type of the argument is copied from the value that was converted while parsing, any other T is converted each time
+         * it is requested. Raises an error when the key is unknown or when the argument is missing or invalid
+         */
+        template <typename T> T get(std::string_view key) const {
+            const Entry &entry = _entry(key);
+            const Value &value = values_[entry.index_];
+            if (value.error_code != ErrorCode::NONE)
+                ARGPARSE_THROW(std::runtime_error(entry._error_message(value.error_code, value.error_value, value.detail)));
+            if (value.converted != nullptr && entry.data_.holds<T>())
+                return *static_cast<const T*>(value.converted.get());
+            T out{};
+            if (value.is_multi) {
+                size_t i = 0;
+                std::string detail;
+                const ErrorCode code = ConvertType<T>::convert_multi(&out, multi_values_.data() + value.first, value.n, i, &detail);
+                if (code != ErrorCode::NONE)
+                    throw_convert_error<T>(code, detail);
+            } else if (value.raw.has_value()) {
+                convert_into(*value.raw, out);
+            } else if (const T *default_value = entry.data_.default_value<T>()) {
+                return *default_value;
+            } else {
+                convert_into(entry._default_string(), out);     // arguments without any default are reported as missing
+            }
+            return out;
+        }
+
+        // The selected subcommand, or nullptr when no subcommand was given. Its errors are included in those of its parent
+        [[nodiscard]] const ParsedArgs *subcommand() const { return subargs_.get(); }
+
+    private:
+        struct Value {
+            std::optional<std::string_view> raw;    // view of the raw input like Entry::value_, which is empty for multi-arguments
+            size_t first = 0;                       // the input of a multi-argument, in multi_values_
+            size_t n = 0;
+            bool is_multi = false;
+            ErrorCode error_code = ErrorCode::NONE;
+            std::string_view error_value;
+            std::string detail;                     // message of the exception thrown by a custom type
+            std::shared_ptr<void> converted;        // the value converted while parsing, of the declared type of the entry (if keepable)
+
+            void set_error(ErrorCode code, std::string_view v) {
+                if (code != ErrorCode::NONE) {
+                    error_code = code;
+                    error_value = v;
+                }
+            }
+        };
+
+        // Receives the values found by `Args::_scan` and `Args::_assign_positionals`, which are validated and recorded without touching the entries
+        struct Sink {
+            ParsedArgs &out;
+            std::pmr::vector<ParseError> &errors;
+
+            void value(const Entry *entry, std::string_view v) {
+                Value &value = out.values_[entry->index_];
+                value.raw = v;
+                value.is_multi = false;
+                std::string_view failed;
+                const ErrorCode code = entry->_check(v, failed, value.detail, &value.converted);
+                value.set_error(code, failed);
+            }
+
+            void values(const Entry *entry, const std::string_view *v, size_t n) {
+                Value &value = out.values_[entry->index_];
+                value.raw = std::string_view();
+                value.is_multi = true;
+                value.first = out.multi_values_.size();
+                value.n = n;
+                out.multi_values_.insert(out.multi_values_.end(), v, v + n);
+                size_t i = 0;
+                const ErrorCode code = entry->_check_multi(v, n, i, value.detail, &value.converted);
+                value.set_error(code, code != ErrorCode::NONE ? v[i] : std::string_view());
+            }
+
+            void missing_value(const Entry *entry, std::string_view key) { out.values_[entry->index_].set_error(ErrorCode::MISSING_VALUE, key); }
+            void unrecognised(std::string_view key) { errors.push_back({ErrorCode::UNRECOGNISED_ARGUMENT, key, std::string_view(), nullptr, {}}); }
+        };
+
+        const Args *schema_;
+        Tokens tokens_;
+        std::vector<Value> values_;                         // the value of every entry, at the index of the entry in Args::all_entries
+        std::pmr::vector<std::string_view> multi_values_;
+        std::pmr::vector<ParseError> errors_;
+        std::unique_ptr<ParsedArgs> subargs_;
+
+        [[nodiscard]] const Entry &_entry(std::string_view key) const {
+            const Entry *entry = schema_->_find_entry(key);
+            if (entry == nullptr)
+                ARGPARSE_THROW(std::invalid_argument("unknown argument: " + std::string(key)));
+            return *entry;
+        }
+
+        friend class Args;
+        friend class FrozenArgs;
+    };
+
+    inline void Args::_parse_frozen(ParsedArgs &out, std::pmr::vector<ParseError> &errors) const {
+        out.values_.assign(all_entries.size(), ParsedArgs::Value());
+
+        if (!subcommand_entries.empty()) {
+            const size_t i = _find_subcommand(out.tokens_);
+            if (i < out.tokens_.params.size()) {
+                const SubcommandEntry &subentry = *subcommand_index.find(out.tokens_.params[i]);
+                out.subargs_ = std::make_unique<ParsedArgs>(subentry.subargs.get());
+                ParsedArgs &sub = *out.subargs_;
+                sub.program_name = subentry.subcommand_name;
+                sub.tokens_.params.assign(out.tokens_.params.begin() + i + 1, out.tokens_.params.end());
+                sub.tokens_.files = out.tokens_.files;
+                subentry.subargs->_parse_frozen(sub, errors);
+                out.tokens_.params.resize(i);   // the arguments up to the subcommand are parsed by this parser
+            }
+        }
+
+        ParsedArgs::Sink sink{out, errors};
+        std::pmr::vector<std::string_view> flat(out.tokens_.params.get_allocator().resource());
+        _scan(out.tokens_, flat, sink);
+        _assign_positionals(flat, sink);
+
+        // arguments that have not been set take their default, of which only those given as a string need to be validated
+        for (const auto &entry : all_entries) {
+            ParsedArgs::Value &value = out.values_[entry->index_];
+            if (value.raw.has_value() || entry->data_.has_default())
+                continue;
+            if (entry->default_str_.has_value()) {
+                std::string_view failed;
+                const ErrorCode code = entry->_check(*entry->default_str_, failed, value.detail, &value.converted);
+                value.set_error(code, failed);
+            } else if (value.error_code == ErrorCode::NONE) {
+                value.error_code = ErrorCode::MISSING_ARGUMENT;
+            }
+        }
+
+        for (const auto &entry : all_entries) {
+            const ParsedArgs::Value &value = out.values_[entry->index_];
+            if (value.error_code != ErrorCode::NONE)
+                errors.push_back({value.error_code, entry->keys_.str(), value.error_value, entry.get(), value.detail});
+        }
+    }
+
+    /* A parser of which the schema is frozen, such that it can be shared between threads to parse many commandlines at once.
+     * Every commandline is parsed into a separate ParsedArgs, while the schema itself is never modified, e.g.
+     *      const argparse::FrozenArgs parser = argparse::freeze<MyArgs>();
+     *      std::vector<argparse::ParsedArgs> results = parser.parse_batch(commandlines);
+     *      int number = results[0].get<int>("number");
+     */
+    class FrozenArgs {
+    public:
+        // Freeze `args`, constructing all of its (lazy) subcommands. The fields of `args` itself are not used by the frozen parser
+        explicit FrozenArgs(std::shared_ptr<Args> args) : args_(std::move(args)) {
+            args_->_freeze(true);
+        }
+
+        [[nodiscard]] const Args &args() const { return *args_; }
+
+        // Parse a single commandline, of which argv[0] is the program. The --help flag is not handled, but can be read like any other flag
+        [[nodiscard]] ParsedArgs parse(int argc, const char* const *argv) const {
+            ParsedArgs result(args_.get());
+            _parse(result, (size_t)argc, [&](size_t i) { return std::string_view(argv[i]); });
+            return result;
+        }
+
+        /* Parse all `commandlines` on `n_threads` threads, using all cores when 0. Every commandline is a container of tokens starting with the program,
+         * such as std::vector<std::string> or std::vector<const char*>. The results are in the same order as the commandlines
+         */
+        template <typename Commandlines> [[nodiscard]] std::vector<ParsedArgs> parse_batch(const Commandlines &commandlines, size_t n_threads=0) const {
+            std::vector<ParsedArgs> results;
+            results.reserve(commandlines.size());
+            for (size_t i = 0; i < commandlines.size(); i++)
+                results.emplace_back(args_.get());
+            parallel_for(commandlines.size(), [&](size_t i) {
+                const auto &commandline = commandlines[i];
+                _parse(results[i], commandline.size(), [&](size_t j) { return std::string_view(commandline[j]); });
+            }, n_threads);
+            return results;
+        }
+
+    private:
+        std::shared_ptr<Args> args_;
+
+        template <typename F> void _parse(ParsedArgs &result, size_t n_tokens, F &&token) const {
+            if (n_tokens > 0)
+                result.program_name = Args::_program_name(token(0));
+            for (size_t i = 1; i < n_tokens; i++)
+                result.tokens_.add(token(i), result.errors_);
+            static_cast<const Args&>(*args_)._parse_frozen(result, result.errors_);
+        }
+    };
+
+    // Construct T and freeze it into a parser that can be shared between threads
+    template <typename T> FrozenArgs freeze() {
+        static_assert(std::is_base_of_v<Args, T>, "Frozen type must be a derivative of argparse::Args");
+        return FrozenArgs(std::make_shared<T>());
+    }
+
     template <typename T> T parse(int argc, const char* const *argv, const bool &raise_on_error=false) {
         T args = T();
         args.parse(argc, argv, raise_on_error);
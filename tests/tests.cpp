@@ -5,12 +5,58 @@
  */
 #undef NDEBUG
 #include <iostream>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#include <thread>
 
-#include "argparse/argparse.hpp"
+#include "argparse/argparse.hpp"     // built both with and without ARGPARSE_ENABLE_STATS
 
 using namespace std;
 
+// Count all heap allocations, to verify that re-parsing does not allocate
+static std::atomic<size_t> allocation_count{0};   // atomic, since FrozenArgs::parse_batch allocates from multiple threads
+static std::atomic<size_t> allocation_bytes{0};
+void *operator new(size_t size) {
+    allocation_count++;
+    allocation_bytes += size;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void *operator new(size_t size, std::align_val_t alignment) {   // used by std::pmr::new_delete_resource
+    allocation_count++;
+    allocation_bytes += size;
+    const size_t a = (size_t)alignment;
+#ifdef _WIN32
+    if (void *p = _aligned_malloc(size ? size : 1, a))
+#else
+    if (void *p = std::aligned_alloc(a, (size + a - 1) / a * a + (size == 0 ? a : 0)))
+#endif
+        return p;
+    throw std::bad_alloc();
+}
+#ifdef _WIN32
+void operator delete(void *p, std::align_val_t) noexcept { _aligned_free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { _aligned_free(p); }
+#else
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
+
 struct Custom {
     std::string message;
 
@@ -46,6 +92,18 @@ template <typename T> T test_args(std::string command) {
     return args;
 }
 
+struct SchemaArgs : public argparse::Args {
+    static constexpr auto schema = argparse::make_schema(argparse::positional("src"), argparse::option("k,key"), argparse::option("n,numbers"), argparse::option("v,verbose"), argparse::positional("dst"));
+    std::string &src                = arg(schema[0], "Source path");
+    int &k                          = kwarg(schema[1], "A number", "3");
+    std::vector<int> &numbers       = kwarg(schema[2], "Some numbers").set_default("1,2");
+    bool &verbose                   = flag(schema[3], "A flag to toggle verbose");
+    std::string &dst                = arg(schema[4], "Destination path").set_default("out");
+    int &runtime                    = kwarg("r,runtime", "A key registered at runtime").set_default(0);
+};
+static_assert(SchemaArgs::schema.find("key") == 1 && SchemaArgs::schema.find("v") == 3 && SchemaArgs::schema.find("src") == -1);
+static_assert(SchemaArgs::schema.n_positional() == 2);
+
 void TEST_MULTI() {
     struct Args : public argparse::Args {
         std::string &A = arg("Source path");
@@ -104,9 +162,62 @@ void TEST_ENUM() {
         assert(args.color2 == RED);
         assert(args.color3 == GREEN);
     }
+
+    {
+        assert(argparse::get<Color>("GrEeN") == GREEN);
+        assert(argparse::toString(BLUE) == "BLUE" && argparse::toString(Color(42)) == "unknown");
+        Color color = RED;
+        assert(argparse::try_convert("purple", color) == argparse::ErrorCode::NOT_ALLOWED && color == RED);
+        const std::vector<Color> colors = argparse::get<std::vector<Color>>("red,Blue,GREEN,blue");
+        assert(colors.size() == 4 && colors[1] == BLUE && colors[2] == GREEN && colors[3] == BLUE);
+    }
 }
 #endif
 
+// Hand-written reflections, so the enum tables are tested without magic_enum
+enum class Level { LOW = -1, MID = 3, HIGH = 1000 };
+struct LevelReflection {
+    static constexpr std::array<std::string_view, 3> names = {"LOW", "MID", "HIGH"};
+    static constexpr std::array<Level, 3> values = {Level::LOW, Level::MID, Level::HIGH};
+};
+struct PrimeReflection {
+    static constexpr std::array<std::string_view, 4> names = {"two", "three", "five", "seven"};
+    static constexpr std::array<int, 4> values = {2, 3, 5, 7};
+};
+enum class Empty {};
+struct EmptyReflection {
+    static constexpr std::array<std::string_view, 0> names{};
+    static constexpr std::array<Empty, 0> values{};
+};
+
+void TEST_ENUM_TABLE() {
+    {
+        using Levels = argparse::BasicEnumTable<Level, LevelReflection>;
+        static_assert(!Levels::dense);
+        Level level = Level::LOW;
+        assert(Levels::find("high", level) && level == Level::HIGH);
+        assert(!Levels::find("medium", level) && level == Level::HIGH);
+        assert(Levels::name(Level::MID) == "MID" && Levels::name(Level(2)).empty());
+    }
+
+    {
+        using Primes = argparse::BasicEnumTable<int, PrimeReflection>;
+        static_assert(Primes::dense);
+        int prime = 0;
+        assert(Primes::find("FIVE", prime) && prime == 5);
+        assert(!Primes::find("four", prime) && prime == 5);
+        assert(Primes::name(7) == "seven" && Primes::name(4).empty() && Primes::name(1).empty() && Primes::name(8).empty());
+    }
+
+    {
+        using Empties = argparse::BasicEnumTable<Empty, EmptyReflection>;
+        static_assert(Empties::n == 0);
+        Empty empty{};
+        assert(!Empties::find("", empty) && !Empties::find("anything", empty));
+        assert(Empties::name(Empty(0)).empty());
+    }
+}
+
 void TEST_ALL() {
     struct Args : public argparse::Args {
         std::string& src_path           = arg("Source path");
@@ -320,6 +431,974 @@ void TEST_OPTIONAL_POINTER() {
     }
 }
 
+void TEST_STRING_VIEW() {
+    struct Args : public argparse::Args {
+        std::string_view &name = kwarg("n,name", "A name that refers directly to argv");
+        std::string &text = arg("Text");
+        std::vector<std::string_view> &tags = kwarg("t,tags", "Comma separated tags").set_default("");
+    };
+
+    {
+        std::string command = "argparse_test hello --name=world -t a,b,,c,";
+        const auto &[argc, argv] = get_argc_argv(command);
+        Args args;
+        args.parse(argc, argv, true);
+        assert(args.name == "world");
+        assert(args.name.data() >= command.data() && args.name.data() < command.data() + command.size());   // no copy was made
+        assert(args.text == "hello");
+        assert(args.tags.size() == 4 && args.tags[0] == "a" && args.tags[2].empty() && args.tags[3] == "c");
+        delete[] argv;
+    }
+}
+
+void TEST_MANY_KEYS() {
+    struct Args : public argparse::Args {
+        std::vector<int*> values;
+        bool &x = flag("x", "Flag X");
+        bool &y = flag("y", "Flag Y");
+
+        Args() {
+            for (int i = 0; i < 2000; i++)
+                values.emplace_back(&(int&)kwarg("o,option" + std::to_string(i), "generated option").set_default(i));
+        }
+    };
+
+    {
+        Args args = test_args<Args>("argparse_test --option7 70 --option1999=1 -xy --option0 -5");
+        assert(*args.values[7] == 70);
+        assert(*args.values[1999] == 1);
+        assert(*args.values[0] == -5);
+        assert(*args.values[1000] == 1000);
+        assert(args.x && args.y);
+    }
+}
+
+void TEST_NUMBERS() {
+    struct Args : public argparse::Args {
+        long long &big                  = kwarg("big", "64-bit signed");
+        unsigned long long &ubig        = kwarg("ubig", "64-bit unsigned");
+        int &hex                        = kwarg("hex", "hexadecimal");
+        unsigned &bin                   = kwarg("bin", "binary");
+        short &oct                      = kwarg("oct", "octal");
+        long &neg                       = kwarg("neg", "negative hexadecimal");
+        double &real                    = kwarg("real", "floating point");
+        float &hexfloat                 = kwarg("hexfloat", "hexadecimal floating point");
+        char &c                         = kwarg("c", "char").set_default("0x41");
+    };
+
+    {
+        Args args = test_args<Args>("argparse_test --big -9223372036854775808 --ubig 18446744073709551615 --hex 0xff --bin 0b101 --oct 0o17 --neg=-0x10 --real +1e3 --hexfloat 0x1p3");
+        assert(args.big == std::numeric_limits<long long>::min());
+        assert(args.ubig == std::numeric_limits<unsigned long long>::max());
+        assert(args.hex == 255);
+        assert(args.bin == 5);
+        assert(args.oct == 15);
+        assert(args.neg == -16);
+        assert(args.real == 1000.0);
+        assert(args.hexfloat == 8.0f);
+        assert(args.c == 'A');
+    }
+
+    for (const std::string command : {"--ubig=-1", "--oct=40000", "--hex=12abc", "--big=9223372036854775808", "--real=1e999", "--hex=0x"}) {
+        std::string full_command = "argparse_test --big 1 --ubig 1 --hex 1 --bin 1 --oct 1 --neg 1 --real 1 --hexfloat 1 " + command;
+        const auto &[argc, argv] = get_argc_argv(full_command);
+        bool raised = false;
+        try {
+            argparse::parse<Args>(argc, argv, true);
+        } catch (const std::runtime_error &e) {
+            raised = true;
+        }
+        assert(raised);
+        delete[] argv;
+    }
+
+    // every character type is range checked on its own, rather than accepting any byte
+    signed char sc = 0;
+    unsigned char uc = 0;
+    assert(argparse::try_convert("-128", sc) == argparse::ErrorCode::NONE && sc == -128);
+    assert(argparse::try_convert("200", sc) == argparse::ErrorCode::OUT_OF_RANGE && sc == -128);
+    assert(argparse::try_convert("255", uc) == argparse::ErrorCode::NONE && uc == 255);
+    assert(argparse::try_convert("-1", uc) == argparse::ErrorCode::OUT_OF_RANGE && uc == 255);
+
+    int value = 0;
+    assert(argparse::parse_number("2147483647", value) == std::errc() && value == 2147483647);
+    assert(argparse::parse_number("2147483648", value) == std::errc::result_out_of_range);
+    assert(argparse::parse_number("-2147483648", value) == std::errc() && value == std::numeric_limits<int>::min());
+    assert(argparse::parse_number("--1", value) == std::errc::invalid_argument);
+    assert(argparse::parse_number(" 1", value) == std::errc::invalid_argument);
+    float f = 0;
+    assert(argparse::parse_number("0.5f", f) == std::errc() && f == 0.5f);
+    assert(argparse::parse_number("inf", f) == std::errc() && std::isinf(f));
+}
+
+void TEST_LARGE_VECTOR() {
+    struct Args : public argparse::Args {
+        std::vector<int> &ids = kwarg("ids", "A large comma-separated list of ids");
+    };
+
+    std::string list;
+    for (int i = 0; i < 100000; i++)
+        list += std::to_string(i * 7) + (i % 33 == 0? ",," : ",");   // includes empty elements at varying offsets
+
+    std::string command = "argparse_test --ids " + list;
+    const auto &[argc, argv] = get_argc_argv(command);
+    std::vector<int> expected;
+    argparse::for_each_split(list, [&](std::string_view v) { expected.emplace_back(v.empty()? -1 : argparse::get<int>(v)); });
+    assert(expected.size() == argparse::count_split(list));
+    assert(expected.size() == 100000 + 3031);
+
+    bool raised = false;
+    try {
+        argparse::parse<Args>(argc, argv, true);    // the empty elements are not valid integers
+    } catch (const std::runtime_error &e) {
+        raised = true;
+    }
+    assert(raised);
+    delete[] argv;
+
+    std::vector<int> ids = argparse::get<std::vector<int>>("1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,");
+    assert(ids.size() == 34 && ids.capacity() == 34 && ids[33] == 34);
+}
+
+void TEST_MULTI_COMMAS() {
+    struct Args : public argparse::Args {
+        std::string &A                  = arg("Source path");
+        std::vector<std::string> &B     = arg("Variable paths").multi_argument();
+        std::string &C                  = arg("Last");
+        std::vector<std::string> &files = kwarg("files", "multiple arguments").multi_argument();
+        std::vector<int> &numbers       = kwarg("numbers", "multiple numbers").multi_argument();
+    };
+
+    {
+        Args args = test_args<Args>("argparse_test a b,1 b,2 c --files x,y z --numbers 1 2 3");
+        assert(args.A == "a");
+        assert(args.B.size() == 2 && args.B[0] == "b,1" && args.B[1] == "b,2");
+        assert(args.C == "c");
+        assert(args.files.size() == 2 && args.files[0] == "x,y" && args.files[1] == "z");
+        assert(args.numbers.size() == 3 && args.numbers[2] == 3);
+    }
+
+    {
+        std::string command = "argparse_test a b c --files --numbers 1 x 3";
+        const auto &[argc, argv] = get_argc_argv(command);
+        try {
+            argparse::parse<Args>(argc, argv, true);
+            assert(false);
+        } catch (const std::runtime_error &e) {
+            assert(std::string(e.what()) == "Invalid argument, could not convert \"x\" for --numbers (multiple numbers)");
+        }
+        delete[] argv;
+    }
+}
+
+void TEST_RESPONSE_FILE() {
+    struct Args : public argparse::Args {
+        std::string &src                = arg("Source path");
+        std::vector<std::string> &files = kwarg("files", "multiple arguments").multi_argument();
+        int &k                          = kwarg("k", "A number");
+        bool &verbose                   = flag("v,verbose", "A flag to toggle verbose");
+    };
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string outer = (dir / "argparse_test_outer.rsp").string(), inner = (dir / "argparse_test_inner.rsp").string();
+    std::ofstream(inner) << "-k 5\n--verbose\n";
+    std::ofstream(outer) << "source\n--files a 'b c' \"d\"\n@" + inner;
+
+    {
+        Args args = test_args<Args>("argparse_test @" + outer);
+        assert(args.src == "source");
+        assert(args.files.size() == 3 && args.files[1] == "b c" && args.files[2] == "d");
+        assert(args.k == 5);
+        assert(args.verbose);
+    }
+
+    {
+        Args args = test_args<Args>("argparse_test @does_not_exist -k 1 --files");     // unknown response files are treated as regular arguments
+        assert(args.src == "@does_not_exist");
+    }
+
+    std::filesystem::remove(inner);
+    std::filesystem::remove(outer);
+}
+
+void TEST_REPARSE() {
+    struct SubArgs : public argparse::Args {
+        int &level                      = kwarg("l,level", "A level").set_default(1);
+    };
+
+    struct Args : public argparse::Args {
+        std::string_view &src           = arg("Source path");
+        int &k                          = kwarg("k", "A number").set_default(0);
+        double &alpha                   = kwarg("a,alpha", "A real number").set_default("0.5");
+        std::string &name               = kwarg("n,name", "A short name").set_default("none");
+        std::vector<int> &numbers       = kwarg("numbers", "multiple numbers").multi_argument().set_default("1,2,3");
+        bool &verbose                   = flag("v,verbose", "A flag to toggle verbose");
+        SubArgs &sub                    = subcommand("sub");
+    };
+
+    std::string command1 = "argparse_test first -k 3 --alpha=0.25 --name abc --numbers 4 5 6 -v sub --level 7";
+    std::string command2 = "argparse_test second --name xyz";
+    const auto [argc1, argv1] = get_argc_argv(command1);
+    const auto [argc2, argv2] = get_argc_argv(command2);
+
+    Args args;
+    for (int warmup = 0; warmup < 2; warmup++) {
+        args.reparse(argc1, argv1, true);
+        args.reparse(argc2, argv2, true);
+    }
+
+    const size_t allocations_before = allocation_count;
+    for (int i = 0; i < 100; i++) {
+        args.reparse(argc1, argv1, true);
+        assert(args.src == "first" && args.k == 3 && args.alpha == 0.25 && args.name == "abc" && args.verbose);
+        assert(args.numbers.size() == 3 && args.numbers[2] == 6);
+        assert(args.sub.is_valid && args.sub.level == 7);
+
+        args.reparse(argc2, argv2, true);
+        assert(args.src == "second" && args.k == 0 && args.alpha == 0.5 && args.name == "xyz" && !args.verbose);
+        assert(args.numbers.size() == 3 && args.numbers[2] == 3);
+        assert(!args.sub.is_valid);
+    }
+    assert(allocation_count == allocations_before);
+
+    delete[] argv1;
+    delete[] argv2;
+}
+
+void TEST_SCHEMA() {
+    {
+        SchemaArgs args = test_args<SchemaArgs>("argparse_test a b --key=5 -v --numbers 3,4,5 -r 2");
+        assert(args.src == "a" && args.dst == "b");
+        assert(args.k == 5);
+        assert(args.numbers.size() == 3 && args.numbers[2] == 5);
+        assert(args.verbose);
+        assert(args.runtime == 2);
+    }
+    {
+        SchemaArgs args = test_args<SchemaArgs>("argparse_test a -k");
+        assert(args.src == "a" && args.dst == "out");
+        assert(args.k == 3);
+        assert(args.numbers.size() == 2);
+        assert(!args.verbose);
+    }
+
+    // an argument of the wrong kind could never be reached, and a Schema that is constructed at runtime can not fail to compile
+    struct OptionAsPositional : public argparse::Args {
+        int &k                          = arg(SchemaArgs::schema[1], "A number");
+    };
+    struct PositionalAsOption : public argparse::Args {
+        std::string &src                = kwarg(SchemaArgs::schema[0], "Source path");
+    };
+    const auto throws_invalid_argument = [](auto &&f) {
+        try {
+            f();
+        } catch (const std::invalid_argument &) {
+            return true;
+        }
+        return false;
+    };
+    assert(throws_invalid_argument([] { OptionAsPositional args; }));
+    assert(throws_invalid_argument([] { PositionalAsOption args; }));
+    assert(throws_invalid_argument([] { (void)argparse::make_schema(argparse::option("k,key"), argparse::option("key")); }));
+    assert(throws_invalid_argument([] { (void)argparse::make_schema(argparse::option("k,")); }));
+}
+
+void TEST_LAZY_SUBCOMMANDS() {
+    static int n_constructed = 0;
+    struct CommitArgs : public argparse::Args {
+        std::string &message            = kwarg("m,message", "Use the given <msg> as the commit message.");
+        CommitArgs() { n_constructed++; }
+    };
+
+    struct PushArgs : public argparse::Args {
+        std::string &source             = arg("Source repository").set_default("origin");
+        PushArgs() { n_constructed++; }
+    };
+
+    struct MainArgs : public argparse::Args {
+        bool &verbose                   = flag("v,verbose", "A flag to toggle verbose");
+        std::shared_ptr<CommitArgs> &commit = subcommand("commit");
+        std::shared_ptr<PushArgs> &push = subcommand("push");
+    };
+
+    {
+        MainArgs args = test_args<MainArgs>("argparse_test --verbose");
+        assert(n_constructed == 0);
+        assert(args.commit == nullptr && args.push == nullptr);
+    }
+
+    {
+        MainArgs args = test_args<MainArgs>("argparse_test commit -m hello");
+        assert(n_constructed == 1);
+        assert(args.push == nullptr);
+        assert(args.commit != nullptr && args.commit->is_valid && args.commit->message == "hello");
+        assert(args.commit->program_name == "commit");
+    }
+}
+
+void TEST_SUBCOMMAND_DISPATCH() {
+    struct CommitArgs : public argparse::Args {
+        std::string &message            = kwarg("m,message", "Use the given <msg> as the commit message.");
+    };
+
+    struct PushArgs : public argparse::Args {
+        std::string &source             = arg("Source repository").set_default("origin");
+    };
+
+    struct MainArgs : public argparse::Args {
+        std::string &mode               = kwarg("m,mode", "A mode, which may be named like a subcommand").set_default("none");
+        std::string &repo               = arg("Repository").set_default(".");
+        CommitArgs &commit              = subcommand("commit");
+        PushArgs &push                  = subcommand("push");
+    };
+
+    {
+        MainArgs args = test_args<MainArgs>("argparse_test -m commit push commit");
+        assert(args.mode == "commit");
+        assert(!args.commit.is_valid);
+        assert(args.push.is_valid && args.push.source == "commit");
+    }
+
+    {
+        MainArgs args = test_args<MainArgs>("argparse_test --mode=fast repo commit -m push");
+        assert(args.mode == "fast" && args.repo == "repo");
+        assert(!args.push.is_valid);
+        assert(args.commit.is_valid && args.commit.message == "push");
+    }
+
+    struct MultiArgs : public argparse::Args {
+        std::vector<std::string> &files = arg("Files").multi_argument();
+        CommitArgs &commit              = subcommand("commit");
+    };
+
+    {
+        MultiArgs args = test_args<MultiArgs>("argparse_test a b c commit -m message");  // a multi-valued positional takes any number of values before the subcommand
+        assert(args.files == std::vector<std::string>({"a", "b", "c"}));
+        assert(args.commit.is_valid && args.commit.message == "message");
+    }
+}
+
+struct Slow {
+    std::string value;
+
+    Slow() = default;
+    Slow(const std::string &v) : value(v) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+};
+
+#ifdef ARGPARSE_ENABLE_STATS
+void TEST_STATS() {
+    struct StatsArgs : public argparse::Args {
+        int &number                     = kwarg("n,number", "A number").set_default(1);
+        Slow &slow                      = kwarg("s,slow", "A slow custom type");
+        std::string &src                = arg("Source");
+        std::string &dst                = arg("Destination").set_default("out");
+    };
+
+    argparse::ParseStats::allocation_probe = [] { return allocation_bytes.load(); };
+    StatsArgs args = test_args<StatsArgs>("argparse_test --slow abc source");
+    const argparse::ParseStats &stats = args.stats();
+    assert(stats.n_conversions == 2);   // --slow and source
+    assert(stats.n_defaults == 3);      // --number, Destination and --help
+    assert(stats.n_slowest == 2 && stats.slowest[0].time >= stats.slowest[1].time);   // sorted, slowest first
+    const size_t slow = stats.slowest[0].key == "s,slow" ? 0 : 1;
+    assert(stats.slowest[slow].key == "s,slow" && stats.slowest[1 - slow].key == "arg_0" && stats.slowest[slow].time >= std::chrono::milliseconds(5));
+    assert(stats.phase_time[argparse::ParseStats::CONVERSION] == stats.slowest[0].time + stats.slowest[1].time);  // the conversions are only attributed to their own phase
+    assert(stats.total() >= stats.phase_time[argparse::ParseStats::CONVERSION]);
+    assert(stats.bytes_allocated > 0);
+    argparse::ParseStats::allocation_probe = nullptr;
+}
+#endif
+
+// Memory resource that counts its allocations
+struct CountingResource : public std::pmr::memory_resource {
+    size_t n_allocations = 0;
+
+    void *do_allocate(size_t bytes, size_t alignment) override {
+        n_allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+void TEST_MEMORY_RESOURCE() {
+    struct SubArgs : public argparse::Args {
+        explicit SubArgs(std::pmr::memory_resource *resource) : argparse::Args(resource) {}
+        std::pmr::string &name          = kwarg("n,name", "A name").set_default("none");
+    };
+
+    struct PmrArgs : public argparse::Args {
+        explicit PmrArgs(std::pmr::memory_resource *resource) : argparse::Args(resource) {}
+        std::pmr::string &src           = arg("Source path");
+        std::pmr::vector<int> &numbers  = kwarg("numbers", "multiple numbers").set_default("1,2,3");
+        std::pmr::vector<std::pmr::string> &words = kwarg("w,words", "multiple words").multi_argument().set_default("");
+        SubArgs &sub                    = subcommand("sub");
+    };
+
+    CountingResource counting;
+    {
+        std::pmr::monotonic_buffer_resource arena(&counting);
+        std::string command = "argparse_test a_source_path_that_does_not_fit_in_a_small_string --words=first_long_word,second_long_word sub --name a_name_that_does_not_fit_inline";
+        const auto &[argc, argv] = get_argc_argv(command);
+
+        PmrArgs args(&arena);
+        args.parse(argc, argv, true);
+        assert(args.src == "a_source_path_that_does_not_fit_in_a_small_string" && args.src.get_allocator().resource() == &arena);
+        assert(args.numbers.size() == 3 && args.numbers.get_allocator().resource() == &arena);
+        assert(args.words.size() == 2 && args.words[1] == "second_long_word" && args.words[1].get_allocator().resource() == &arena);
+        assert(args.sub.is_valid && args.sub.resource() == &arena && args.sub.name.get_allocator().resource() == &arena);
+        assert(counting.n_allocations > 0);
+    }
+}
+
+void TEST_VALUE_SLOT() {
+    struct Args : public argparse::Args {
+        double &alpha                   = kwarg("a,alpha", "A real number, with a default of another type").set_default(2);
+        std::optional<int> &k           = kwarg("k", "An optional number");
+        std::string &name               = kwarg("n,name", "A name that does not fit inline").set_default(std::string("a default that is stored on the heap"));
+        std::vector<int> &numbers       = kwarg("numbers", "multiple numbers").set_default(std::vector<int>{1, 2, 3});
+    };
+
+    {
+        Args args = test_args<Args>("argparse_test");
+        assert(args.alpha == 2.0 && !args.k.has_value() && args.name == "a default that is stored on the heap");
+        assert(args.numbers.size() == 3 && args.numbers[2] == 3);
+    }
+
+    {
+        Args args = test_args<Args>("argparse_test -a 0.5 -k 3 --name abc --numbers 4,5");
+        assert(args.alpha == 0.5 && args.k == 3 && args.name == "abc" && args.numbers.size() == 2);
+    }
+
+    // Scalar fields and their defaults are stored inline, so registering one only allocates the entry itself
+    struct ScalarArgs : public argparse::Args {
+        explicit ScalarArgs(std::pmr::memory_resource *resource) : argparse::Args(resource) {
+            for (int i = 0; i < 100; i++)
+                (void)(int&)kwarg("k" + std::to_string(i), "A number").set_default(i);
+        }
+    };
+    CountingResource counting;
+    ScalarArgs args(&counting);
+    assert(counting.n_allocations < 120);  // 100 entries, and the growth of the list of entries
+}
+
+// A custom type that counts how often it is converted from a string
+struct CountedValue {
+    static inline std::atomic<int> n_converted{0};
+    std::string value;
+
+    CountedValue() = default;
+    explicit CountedValue(std::string_view v) : value(v) { n_converted++; }
+};
+
+void TEST_FROZEN() {
+    struct CommitArgs : public argparse::Args {
+        std::string &message            = kwarg("m,message", "Use the given <msg> as the commit message.");
+    };
+
+    struct BatchArgs : public argparse::Args {
+        int &number                     = kwarg("n,number", "A number").set_default(1);
+        std::vector<int> &numbers       = kwarg("numbers", "multiple numbers").multi_argument().set_default("");
+        std::string &src                = arg("src", "Source");
+        std::shared_ptr<CommitArgs> &commit = subcommand("commit");
+    };
+
+    const argparse::FrozenArgs parser = argparse::freeze<BatchArgs>();
+    std::vector<std::vector<std::string>> commandlines;
+    for (int i = 0; i < 1000; i++) {
+        switch (i % 4) {
+            case 0: commandlines.push_back({"argparse_test", "source" + std::to_string(i), "-n", std::to_string(i)}); break;
+            case 1: commandlines.push_back({"argparse_test", "source", "--numbers", "1", "2", std::to_string(i)}); break;
+            case 2: commandlines.push_back({"argparse_test", "source", "-n", "not_a_number", "--unknown"}); break;
+            case 3: commandlines.push_back({"argparse_test", "source", "commit", "-m", "message" + std::to_string(i)}); break;
+        }
+    }
+
+    const std::vector<argparse::ParsedArgs> results = parser.parse_batch(commandlines, 4);
+    assert(results.size() == commandlines.size());
+    for (size_t i = 0; i < results.size(); i++) {
+        const argparse::ParsedArgs &result = results[i];
+        std::vector<const char*> argv;
+        for (const std::string &token : commandlines[i])
+            argv.push_back(token.c_str());
+        BatchArgs args;
+        const argparse::ParseResult &expected = args.try_parse((int)argv.size(), argv.data());
+
+        // the frozen parser finds the same errors as a regular parse
+        assert(result.ok() == expected.ok() && result.errors().size() == expected.errors.size());
+        for (size_t j = 0; j < expected.errors.size(); j++)
+            assert(result.errors()[j].code == expected.errors[j].code && result.errors()[j].message() == expected.errors[j].message());
+        if (!result.ok())
+            continue;
+
+        assert(result.program_name == "argparse_test");
+        assert(result.get<int>("n") == args.number && result.get<int>("number") == args.number && result.is_set("n") == (i % 4 == 0));
+        assert(result.get<std::vector<int>>("numbers") == args.numbers && result.get<std::string>("src") == args.src);
+        assert((result.subcommand() != nullptr) == (args.commit != nullptr && args.commit->is_valid));
+        if (result.subcommand() != nullptr)
+            assert(result.subcommand()->program_name == "commit" && result.subcommand()->get<std::string>("m") == args.commit->message);
+    }
+    assert(results[2].errors().size() == 2 && results[2].errors()[0].code == argparse::ErrorCode::UNRECOGNISED_ARGUMENT);
+    assert(results[2].errors()[1].code == argparse::ErrorCode::INVALID_VALUE);
+
+    // a missing required argument, and an unknown key
+    const char *argv[] = {"argparse_test", "commit"};
+    const argparse::ParsedArgs result = parser.parse(2, argv);
+    assert(result.errors().size() == 2 && result.errors()[0].code == argparse::ErrorCode::MISSING_ARGUMENT);    // --message of the subcommand first
+    assert(result.errors()[1].code == argparse::ErrorCode::MISSING_ARGUMENT && result.errors()[1].key == "src");
+    bool thrown = false;
+    try {
+        result.get<int>("unknown");
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // a value of the declared type is converted once while parsing, and copied out by every get
+    struct CountedArgs : public argparse::Args {
+        CountedValue &value             = kwarg("v,value", "A value that is converted once");
+    };
+    const argparse::FrozenArgs counted_parser = argparse::freeze<CountedArgs>();
+    const char *counted_argv[] = {"argparse_test", "-v", "abc"};
+    CountedValue::n_converted = 0;
+    const argparse::ParsedArgs counted = counted_parser.parse(3, counted_argv);
+    assert(counted.get<CountedValue>("v").value == "abc" && counted.get<CountedValue>("value").value == "abc");
+    assert(CountedValue::n_converted == 1 && counted.get<std::string>("v") == "abc");
+
+    // the work is spread over all threads, and all indices are visited exactly once
+    std::vector<std::atomic<int>> visited(10000);
+    argparse::parallel_for(visited.size(), [&](size_t i) { visited[i]++; }, 8);
+    assert(std::all_of(visited.begin(), visited.end(), [](const std::atomic<int> &v) { return v == 1; }));
+
+    // a nested parallel_for runs on the thread that calls it, instead of starting threads of its own
+    std::atomic<int> n_foreign{0};
+    argparse::parallel_for(8, [&](size_t) {
+        const std::thread::id outer = std::this_thread::get_id();
+        argparse::parallel_for(100, [&](size_t) { n_foreign += std::this_thread::get_id() != outer; }, 8);
+    }, 4);
+    assert(n_foreign == 0 && !argparse::in_parallel_for);
+}
+
+// Counts how often it is printed, to verify that defaults are only turned into a string when needed
+struct Printable {
+    static inline int n_printed = 0;
+    int value = 0;
+
+    Printable() = default;
+    Printable(int v) : value(v) {}
+    Printable(const std::string &v) : value(std::stoi(v)) {}
+    friend std::ostream &operator<<(std::ostream &os, const Printable &p) {
+        n_printed++;
+        return os << p.value;
+    }
+};
+
+void TEST_LAZY_DEFAULTS() {
+    struct Args : public argparse::Args {
+        Printable &printable            = kwarg("p", "A printable value").set_default(Printable(7));
+        double &alpha                   = kwarg("a,alpha", "A real number, with a default of another type").set_default(2);
+        std::optional<int> &k           = kwarg("k", "An optional number");
+    };
+
+    Printable::n_printed = 0;
+    std::string command = "argparse_test -k 1";
+    const auto &[argc, argv] = get_argc_argv(command);
+    Args args;
+    args.parse(argc, argv, true);
+    assert(Printable::n_printed == 0 && args.printable.value == 7 && args.alpha == 2.0 && args.k == 1);
+    args.print();
+    args.help();
+    assert(Printable::n_printed == 2);      // once for the value, and once for the default in the help
+}
+
+void TEST_PARALLEL_VECTOR() {
+    // Convert a list with both the sequential and the parallel conversion, which must agree on the elements and the first error
+    auto compare = [](const std::string &list) {
+        std::vector<int> sequential, parallel;
+        std::string_view failed_sequential, failed_parallel;
+        argparse::parallel_threshold = SIZE_MAX;
+        const argparse::ErrorCode code = argparse::try_convert_split(list, sequential, failed_sequential);
+        argparse::parallel_threshold = 2;
+        assert(argparse::try_convert_split(list, parallel, failed_parallel) == code);
+        assert(parallel == sequential && failed_parallel.data() == failed_sequential.data() && failed_parallel.size() == failed_sequential.size());
+        argparse::parallel_threshold = 1 << 16;
+        return code;
+    };
+
+    std::string list;
+    for (int i = 0; i < 50000; i++)
+        list += std::to_string(i) + ",";
+    assert(compare(list) == argparse::ErrorCode::NONE);
+    assert(compare(list + "7") == argparse::ErrorCode::NONE);
+    assert(compare(list.substr(0, 1000) + "a," + list.substr(1000) + "b") == argparse::ErrorCode::INVALID_VALUE);   // the first of two errors
+    assert(compare(list + list + "99999999999") == argparse::ErrorCode::OUT_OF_RANGE);
+    assert(compare("1,2,,3") == argparse::ErrorCode::INVALID_VALUE);
+    assert(compare(",,,,") == argparse::ErrorCode::INVALID_VALUE);
+    assert(compare("12345") == argparse::ErrorCode::NONE);
+    assert(compare("") == argparse::ErrorCode::NONE);
+
+    // Through a parser, of which the error points at the first element that failed, both for comma-separated lists and for multiple arguments
+    struct Args : public argparse::Args {
+        std::vector<double> &values     = kwarg("v,values", "A large comma-separated list");
+        std::vector<long> &ids          = kwarg("ids", "A large list of ids").multi_argument().set_default("");
+    };
+    argparse::parallel_threshold = 1000;
+    std::string ids;
+    for (int i = 0; i < 5000; i++)
+        ids += " " + std::to_string(i);
+    {
+        std::string command = "argparse_test --values " + list + "0.5 --ids" + ids;
+        const auto &[argc, argv] = get_argc_argv(command);
+        Args args;
+        assert(args.try_parse(argc, argv).ok());
+        assert(args.values.size() == 50001 && args.values[49999] == 49999 && args.values[50000] == 0.5);
+        assert(args.ids.size() == 5000 && args.ids[4321] == 4321);
+    }
+    {
+        std::string invalid = "argparse_test --values " + list + "0.5 --ids" + ids + " 12x 13y";
+        const auto &[argc, argv] = get_argc_argv(invalid);
+        Args args;
+        const argparse::ParseResult &result = args.try_parse(argc, argv);
+        assert(result.errors.size() == 1 && result.errors[0].value == "12x" && args.ids.size() == 5000);
+    }
+    {
+        std::string invalid = "argparse_test --values 1,2,three," + list;
+        const auto &[argc, argv] = get_argc_argv(invalid);
+        Args args;
+        const argparse::ParseResult &result = args.try_parse(argc, argv);
+        assert(result.errors.size() == 1 && result.errors[0].value == "three" && args.values.size() == 2);
+    }
+    argparse::parallel_threshold = 1 << 16;
+}
+
+void TEST_LAZY_LIST() {
+    struct Args : public argparse::Args {
+        argparse::lazy_list<std::string_view> &files = arg("Files").multi_argument();
+        argparse::lazy_list<int> &numbers = kwarg("n,numbers", "Numbers that are converted when iterated").multi_argument().set_default("");
+        argparse::lazy_list<double> &values = kwarg("v,values", "Comma-separated values").set_default("0.5,1.5");
+    };
+
+    std::string command = "argparse_test a.txt b,c.txt d.txt -n 1 2 x 4";
+    const auto &[argc, argv] = get_argc_argv(command);
+    Args args;
+    args.parse(argc, argv, true);   // the invalid number is not converted while parsing
+
+    assert(args.files.size() == 3 && !args.files.empty());
+    std::vector<std::string_view> files(args.files.begin(), args.files.end());
+    assert(files.size() == 3 && files[1] == "b,c.txt" && files[2].data() == argv[3]);  // views of argv, which are not split on commas
+
+    assert(args.numbers.size() == 4);
+    auto it = args.numbers.begin();
+    assert(*it++ == 1 && *it == 2 && (++it).raw() == "x");
+    bool thrown = false;
+    try {
+        (void)*it;
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    assert(thrown && *++it == 4 && ++it == args.numbers.end());
+
+    double sum = 0;
+    for (double v : args.values)
+        sum += v;
+    assert(args.values.size() == 2 && sum == 2.0);
+    assert(argparse::toString(args.numbers) == "1,2,x,4");
+
+    // reparsing updates the views to the new arguments
+    std::string command2 = "argparse_test e.txt --values 1,,3";
+    const auto &[argc2, argv2] = get_argc_argv(command2);
+    args.reparse(argc2, argv2, true);
+    assert(args.files.size() == 1 && *args.files.begin() == "e.txt" && args.numbers.empty());
+    assert(args.values.size() == 3 && (++args.values.begin()).raw().empty());
+}
+
+void TEST_MAPPED_FILE() {
+    struct Args : public argparse::Args {
+        argparse::mapped_file &input                = arg("Input file").advise(argparse::mapped_file::advice::sequential);
+        std::vector<argparse::mapped_file> &extra   = kwarg("e,extra", "Files that are read at random").multi_argument().advise(argparse::mapped_file::advice::random).set_default("");
+    };
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string a = (dir / "argparse_test_a.bin").string(), b = (dir / "argparse_test_b.bin").string(), empty = (dir / "argparse_test_empty.bin").string();
+    std::ofstream(a) << "hello mapped";
+    std::ofstream(b) << "second";
+    std::ofstream{empty};
+
+    {
+        Args args = test_args<Args>("argparse_test " + a + " -e " + b + " " + empty);
+        assert(args.input.is_open() && args.input.view() == "hello mapped" && args.input.path() == a);
+        assert(args.extra.size() == 2 && args.extra[0].view() == "second");
+        assert(args.extra[1].is_open() && args.extra[1].size() == 0);
+    }
+
+    for (const std::string &path : {(dir / "argparse_test_missing.bin").string(), dir.string()}) {
+        std::string command = "argparse_test " + path;
+        const auto &[argc, argv] = get_argc_argv(command);
+        Args args;
+        const argparse::ParseResult &result = args.try_parse(argc, argv);
+        assert(result.errors.size() == 1 && result.errors[0].code == argparse::ErrorCode::CUSTOM && result.errors[0].value == path);
+        assert(result.errors[0].message().find("could not open file") != std::string::npos && !args.input.is_open());
+
+        argparse::mapped_file file;     // the message is only returned through the detail, when it is asked for
+        std::string detail;
+        assert(argparse::try_convert(path, file) == argparse::ErrorCode::CUSTOM);
+        assert(argparse::try_convert(path, file, &detail) == argparse::ErrorCode::CUSTOM && detail.find("could not open file") == 0);
+    }
+
+    std::filesystem::remove(a);
+    std::filesystem::remove(b);
+    std::filesystem::remove(empty);
+}
+
+// Write a version 1 .npy file, with the header padded to 64 bytes like numpy does
+template <typename T> void write_npy(const std::string &path, const std::string &descr, const std::string &shape, const std::vector<T> &data) {
+    std::string header = "{'descr': '" + descr + "', 'fortran_order': False, 'shape': " + shape + ", }";
+    header.append(63 - (10 + header.size()) % 64, ' ') += '\n';
+    std::ofstream file(path, std::ios::binary);
+    file << "\x93NUMPY" << char(1) << char(0) << char(header.size() & 0xff) << char(header.size() >> 8) << header;
+    file.write((const char *)data.data(), (std::streamsize)(data.size() * sizeof(T)));
+}
+
+void TEST_BINARY_ARRAY() {
+    struct Args : public argparse::Args {
+        std::vector<float> &weights             = kwarg("w,weights", "Weights");
+        std::vector<int64_t> &ids               = kwarg("ids", "Ids").multi_argument().set_default("1,2");
+        argparse::mapped_span<float> &mapped    = kwarg("m,mapped", "Weights used in place").set_default("");
+    };
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string weights = (dir / "argparse_test_weights.npy").string(), ids = (dir / "argparse_test_ids.bin").string(), swapped = (dir / "argparse_test_swapped.npy").string();
+    const std::vector<float> w = {0.1f, -2.5f, 3e8f, 0.f, 1.f, 7.25f};
+    write_npy(weights, "<f4", "(2, 3)", w);
+    std::ofstream(ids, std::ios::binary).write((const char *)std::vector<int64_t>{5, -6, 1LL << 40}.data(), 3 * sizeof(int64_t));
+    std::vector<int64_t> big_endian = {1, -2, 3};
+    for (int64_t &v : big_endian)
+        v = argparse::swap_bytes(v);
+    write_npy(swapped, ">i8", "(3,)", big_endian);
+
+    {
+        Args args = test_args<Args>("argparse_test -w @@" + weights + " --ids @@" + ids + " -m " + weights);
+        assert(args.weights == w);
+        assert(args.ids == std::vector<int64_t>({5, -6, 1LL << 40}));
+        assert(args.mapped.size() == 6 && args.mapped.shape() == std::vector<size_t>({2, 3}) && args.mapped[2] == 3e8f);
+        assert(std::equal(args.mapped.begin(), args.mapped.end(), w.begin()));
+    }
+    {
+        Args args = test_args<Args>("argparse_test -w 1,2 --ids @@" + swapped + " -m @@" + weights);    // other byte orders are swapped while loading
+        assert(args.weights.size() == 2 && args.ids == std::vector<int64_t>({1, -2, 3}) && args.mapped.size() == 6);
+    }
+
+    const std::string text = (dir / "argparse_test_text.bin").string();  // raw numbers without a NUL byte, which are loaded rather than read as a response file
+    std::ofstream(text, std::ios::binary) << "abcdefgh";
+    {
+        Args args = test_args<Args>("argparse_test -w @@" + text);
+        float expected[2];
+        std::memcpy(expected, "abcdefgh", sizeof(expected));
+        assert(args.weights == std::vector<float>(expected, expected + 2));
+    }
+
+    const std::string odd = (dir / "argparse_test_odd.bin").string(), no_colon = (dir / "argparse_test_no_colon.npy").string();
+    std::ofstream(odd, std::ios::binary).write("\0\1\2\3\4", 5);
+    std::ofstream(no_colon, std::ios::binary) << "\x93NUMPY" << char(1) << char(0) << char(10) << char(0) << "{'descr' }";
+    const std::string overflow = (dir / "argparse_test_overflow.npy").string();    // the product of the shape wraps around to 0
+    write_npy(overflow, "<f4", "(65536, 65536, 65536, 65536)", std::vector<float>());
+    const std::pair<std::string, std::string> invalid[] = {
+            {"-w @@" + odd, "not a multiple of the element size"},
+            {"-w @@" + swapped, "dtype '>i8' of the .npy file does not match"},
+            {"-w 1 --ids @@" + weights, "dtype '<f4' of the .npy file does not match"},
+            {"-w 1 -m " + swapped, "dtype '>i8' of the .npy file does not match"},
+            {"-w @@" + no_colon, "invalid .npy header"},
+            {"-w @@" + overflow, "overflows"},
+            {"-w 1 -m " + overflow, "overflows"},
+            {"-w @@" + (dir / "argparse_test_missing.npy").string(), "could not open file"}};
+    for (const auto &[arguments, message] : invalid) {
+        std::string command = "argparse_test " + arguments;
+        const auto &[argc, argv] = get_argc_argv(command);
+        Args args;
+        const argparse::ParseResult &result = args.try_parse(argc, argv);
+        assert(result.errors.size() == 1 && result.errors[0].code == argparse::ErrorCode::CUSTOM);
+        assert(result.errors[0].message().find(message) != std::string::npos);
+    }
+
+    std::filesystem::remove(weights);
+    std::filesystem::remove(ids);
+    std::filesystem::remove(swapped);
+    std::filesystem::remove(odd);
+    std::filesystem::remove(no_colon);
+    std::filesystem::remove(overflow);
+    std::filesystem::remove(text);
+}
+
+// A custom type of which the conversion waits for `n_expected` conversions to be in flight at the same time, which only happens when they run concurrently
+struct SlowResource {
+    static inline std::mutex mutex;
+    static inline std::condition_variable started;
+    static inline int n_started = 0;
+    static inline int n_expected = 0;
+
+    std::string name;
+    std::thread::id loaded_by;
+    bool overlapped = false;    // whether all expected conversions were in flight together, rather than waiting in vain until the timeout
+
+    SlowResource() = default;
+    explicit SlowResource(std::string_view v) : name(v), loaded_by(std::this_thread::get_id()) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            n_started++;
+            started.notify_all();
+            overlapped = started.wait_for(lock, std::chrono::seconds(10), [] { return n_started >= n_expected; });
+        }
+        if (name == "invalid")
+            throw std::runtime_error("could not load " + name);
+    }
+};
+
+void TEST_INDEPENDENT() {
+    struct Args : public argparse::Args {
+        SlowResource &model     = kwarg("m,model", "A model").independent();
+        SlowResource &database  = kwarg("d,database", "A database").independent().set_default("default.db");
+        SlowResource &regex     = arg("A regex").independent();
+        int &k                  = kwarg("k", "A number that is converted as usual").set_default(1);
+    };
+
+    {
+        std::string command = "argparse_test pattern -m model.bin -k 3";
+        const auto &[argc, argv] = get_argc_argv(command);
+        Args args;
+        SlowResource::n_started = 0;
+        SlowResource::n_expected = 3;
+        assert(args.try_parse(argc, argv).ok());
+        assert(args.model.name == "model.bin" && args.database.name == "default.db" && args.regex.name == "pattern" && args.k == 3);
+        assert(args.model.loaded_by != args.database.loaded_by && args.model.loaded_by != args.regex.loaded_by);
+        assert(args.model.overlapped && args.database.overlapped && args.regex.overlapped);   // all 3 conversions ran at the same time
+    }
+    {
+        std::string command = "argparse_test invalid -m invalid -k x";
+        const auto &[argc, argv] = get_argc_argv(command);
+        Args args;
+        SlowResource::n_started = 0;
+        const argparse::ParseResult &result = args.try_parse(argc, argv);  // errors are in order of declaration, regardless of which conversion finished first
+        assert(result.errors.size() == 3 && result.errors[0].key == "m,model" && result.errors[1].key == "arg_0" && result.errors[2].key == "k");
+        assert(result.errors[0].message().find("could not load invalid") != std::string::npos);
+    }
+}
+
+// A custom type that counts how often it is converted, and of which the value is checked cheaply while parsing
+struct Model {
+    static inline std::atomic<int> n_loaded{0};
+    static inline std::promise<void> *fallback_started = nullptr;   // fulfilled when the conversion of fallback.bin starts, if set
+    std::string path;
+    std::thread::id loaded_by;
+
+    explicit Model(std::string_view v) : path(v), loaded_by(std::this_thread::get_id()) {
+        if (fallback_started != nullptr && path == "fallback.bin")
+            fallback_started->set_value();
+        n_loaded++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (path == "corrupt.bin")
+            throw std::runtime_error("corrupt model");
+    }
+
+    static bool validate(std::string_view v) { return v.size() > 4 && v.substr(v.size() - 4) == ".bin"; }
+};
+
+void TEST_DEFERRED() {
+    struct Args : public argparse::Args {
+        argparse::deferred<Model> &model        = kwarg("m,model", "A model that is loaded when it is used");
+        argparse::deferred<Model> &fallback     = kwarg("f,fallback", "A model that is loaded right after parsing").prefetch().set_default("fallback.bin");
+        argparse::deferred<int> &k              = kwarg("k", "A deferred number").set_default(7);
+    };
+
+    Model::n_loaded = 0;
+    {
+        std::string command = "argparse_test -m model.bin";
+        const auto &[argc, argv] = get_argc_argv(command);
+        Args args;
+        std::promise<void> fallback_started;
+        Model::fallback_started = &fallback_started;
+        assert(args.try_parse(argc, argv).ok());
+        assert(fallback_started.get_future().wait_for(std::chrono::seconds(10)) == std::future_status::ready);    // prefetched before it is accessed
+        Model::fallback_started = nullptr;
+        assert(args.model.raw() == "model.bin" && argparse::toString(args.model) == "model.bin");
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++)
+            threads.emplace_back([&] { assert(args.model->path == "model.bin"); });
+        for (std::thread &thread : threads)
+            thread.join();
+        assert(args.fallback->path == "fallback.bin" && args.fallback->loaded_by != std::this_thread::get_id());
+        assert(Model::n_loaded == 2 && args.k.get() == 7);    // converted once each, also when accessed concurrently
+    }
+    {
+        std::string command = "argparse_test -m model.txt";    // rejected while parsing, without loading it
+        const auto &[argc, argv] = get_argc_argv(command);
+        Args args;
+        const argparse::ParseResult &result = args.try_parse(argc, argv);
+        assert(result.errors.size() == 1 && result.errors[0].code == argparse::ErrorCode::INVALID_VALUE && result.errors[0].value == "model.txt");
+        assert(!args.fallback.has_value() || args.fallback.raw() == "fallback.bin");
+    }
+    assert(Model::n_loaded == 2);  // nothing is prefetched when parsing fails
+    {
+        std::string command = "argparse_test -m corrupt.bin -k x";  // conversion errors surface on access, and are not retried
+        const auto &[argc, argv] = get_argc_argv(command);
+        Args args;
+        assert(args.try_parse(argc, argv).ok());
+        for (int i = 0; i < 2; i++) {
+            bool thrown = false;
+            try {
+                (void)args.model.get();
+            } catch (const std::runtime_error &e) {
+                thrown = std::string(e.what()) == "corrupt model";
+            }
+            assert(thrown);
+        }
+        bool thrown = false;
+        try {
+            (void)args.k.get();
+        } catch (const std::invalid_argument &) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    assert(Model::n_loaded == 4);
+}
+
+void TEST_UNICODE() {
+    struct Args : public argparse::Args {
+        std::wstring &wide              = kwarg("w,wide", "A wide string");
+        std::u16string &utf16           = kwarg("u16", "A UTF-16 string").set_default("");
+        std::u32string &utf32           = kwarg("u32", "A UTF-32 string").set_default("");
+        std::filesystem::path &path     = kwarg("p,path", "A path").set_default("");
+    };
+
+    const std::string long_name = "a_file_name_that_is_longer_than_a_vector_register:gr\xc3\xbc\xc3\x9f" "e_\xe2\x9c\x93_\xf0\x9f\x98\x80.txt";
+    {
+        Args args = test_args<Args>("argparse_test -w h\xc3\xa9llo --u16 " + long_name + " --u32 " + long_name + " -p " + long_name);
+        assert(args.wide == L"h\u00e9llo");
+        assert(args.utf32 == U"a_file_name_that_is_longer_than_a_vector_register:gr\u00fc\u00dfe_\u2713_\U0001F600.txt");
+        assert(args.utf16 == u"a_file_name_that_is_longer_than_a_vector_register:gr\u00fc\u00dfe_\u2713_\U0001F600.txt");
+        assert(argparse::toString(args.utf16) == long_name && argparse::toString(args.utf32) == long_name && argparse::toString(args.wide) == "h\xc3\xa9llo");
+        assert(argparse::toString(args.path) == long_name);
+        assert(argparse::get<std::wstring>(long_name).size() == 63 + (sizeof(wchar_t) == 2));   // the emoji is a surrogate pair in UTF-16
+    }
+
+    // truncated, overlong, unexpected continuation byte, surrogate, beyond U+10FFFF
+    for (const char *invalid : {"abc\xc3", "\xc0\xaf", "\x80" "abc", "x\xed\xa0\x80", "\xf4\x90\x80\x80"}) {
+        std::string command = std::string("argparse_test -w ") + invalid;
+        const auto &[argc, argv] = get_argc_argv(command);
+        Args args;
+        const argparse::ParseResult &result = args.try_parse(argc, argv);
+        assert(result.errors.size() == 1 && result.errors[0].code == argparse::ErrorCode::INVALID_VALUE && result.errors[0].value == invalid);
+    }
+    assert(argparse::toString(std::u16string(u"a") + char16_t(0xD800) + u"b") == "a\xef\xbf\xbd" "b");   // an unpaired surrogate is replaced by U+FFFD
+}
+
 int main(int argc, char* argv[]) {
     TEST_ALL();
     TEST_MULTI();
@@ -330,12 +1409,37 @@ int main(int argc, char* argv[]) {
 #else
     std::cout << "Magic Enum not installed in this system, therefore native enum support disabled" << std::endl;
 #endif
+    TEST_ENUM_TABLE();
 
     TEST_SUBCOMMANDS();    
     TEST_SHORT_GROUP();
     TEST_EQUALS();
     TEST_EMPTY_MULTI();
     TEST_OPTIONAL_POINTER();
+    TEST_STRING_VIEW();
+    TEST_MANY_KEYS();
+    TEST_NUMBERS();
+    TEST_LARGE_VECTOR();
+    TEST_MULTI_COMMAS();
+    TEST_RESPONSE_FILE();
+    TEST_REPARSE();
+    TEST_SCHEMA();
+    TEST_LAZY_SUBCOMMANDS();
+    TEST_SUBCOMMAND_DISPATCH();
+#ifdef ARGPARSE_ENABLE_STATS
+    TEST_STATS();
+#endif
+    TEST_MEMORY_RESOURCE();
+    TEST_VALUE_SLOT();
+    TEST_FROZEN();
+    TEST_LAZY_DEFAULTS();
+    TEST_PARALLEL_VECTOR();
+    TEST_LAZY_LIST();
+    TEST_MAPPED_FILE();
+    TEST_BINARY_ARRAY();
+    TEST_INDEPENDENT();
+    TEST_DEFERRED();
+    TEST_UNICODE();
 
     std::cout << "finished all tests" << std::endl;
     return 0;
@@ -0,0 +1,161 @@
+/* @author: Morris Franken
+ * Tests for the exception-free parsing mode, which are compiled without exceptions (-fno-exceptions)
+ */
+#undef NDEBUG
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+
+using namespace std;
+
+struct SubArgs : public argparse::Args {
+    int &level                      = kwarg("l,level", "A level");
+};
+
+struct Args : public argparse::Args {
+    std::string &src                = arg("Source path");
+    int &k                          = kwarg("k", "A number").set_default(1);
+    unsigned char &c                = kwarg("c", "A character").set_default('a');
+    std::vector<int> &numbers       = kwarg("n,numbers", "multiple numbers").multi_argument().set_default("1,2");
+    std::optional<float> &alpha     = kwarg("a,alpha", "An optional real number");
+    std::string &name               = kwarg("name", "A name");
+    bool &verbose                   = flag("v,verbose", "A flag to toggle verbose");
+    SubArgs &sub                    = subcommand("sub");
+};
+
+const argparse::ParseResult &try_parse(argparse::Args &args, std::string command) {
+    static std::vector<std::string> tokens;     // the result refers to the commandline, so the tokens are kept alive
+    static std::vector<const char*> argv;
+    tokens.clear();
+    argv.clear();
+    for (size_t start = 0, end = 0; end != std::string::npos; start = end + 1) {
+        end = command.find(' ', start);
+        tokens.emplace_back(command.substr(start, end - start));
+    }
+    for (const std::string &token : tokens)
+        argv.emplace_back(token.c_str());
+    return args.try_parse((int)argv.size(), argv.data());
+}
+
+void TEST_VALID() {
+    Args args;
+    const argparse::ParseResult &result = try_parse(args, "argparse_test source -k 3 --numbers 4 5 6 --name abc -v");
+    assert(result.ok() && result && args.is_valid);
+    assert(args.src == "source" && args.k == 3 && args.numbers.size() == 3 && args.name == "abc" && args.verbose && !args.alpha.has_value());
+}
+
+void TEST_ALL_ERRORS() {
+    Args args;
+    const argparse::ParseResult &result = try_parse(args, "argparse_test -k 1e99 -c 300 --numbers 1 x 3 --alpha abc --unknown --name");
+    assert(!result && !args.is_valid);
+
+    using argparse::ErrorCode;
+    assert(result.errors.size() == 7);
+    assert(result.errors[0].code == ErrorCode::UNRECOGNISED_ARGUMENT && result.errors[0].key == "unknown");
+    assert(result.errors[1].code == ErrorCode::MISSING_ARGUMENT && result.errors[1].key == "arg_0");
+    assert(result.errors[2].code == ErrorCode::INVALID_VALUE && result.errors[2].key == "k" && result.errors[2].value == "1e99");
+    assert(result.errors[3].code == ErrorCode::OUT_OF_RANGE && result.errors[3].key == "c" && result.errors[3].value == "300");
+    assert(result.errors[4].code == ErrorCode::INVALID_VALUE && result.errors[4].key == "n,numbers" && result.errors[4].value == "x");
+    assert(result.errors[5].code == ErrorCode::INVALID_VALUE && result.errors[5].key == "a,alpha" && result.errors[5].value == "abc");
+    assert(result.errors[6].code == ErrorCode::MISSING_VALUE && result.errors[6].key == "name");
+
+    assert(result.errors[0].message() == "unrecognised commandline argument :  unknown");
+    assert(result.errors[1].message() == "Argument missing: arg_0 (Source path)");
+    assert(result.errors[2].message() == "Invalid argument, could not convert \"1e99\" for -k (A number)");
+    assert(result.errors[3].message() == "Invalid argument \"300\" for -c (A character). Error: value out of range");
+    assert(result.errors[4].message() == "Invalid argument, could not convert \"x\" for -n,--numbers (multiple numbers)");
+    assert(result.errors[5].message() == "Invalid argument, could not convert \"abc\" for -a,--alpha (An optional real number)");
+    assert(result.errors[6].message() == "No value provided for: name");
+}
+
+void TEST_SUBCOMMAND_ERRORS() {
+    Args args;
+    const argparse::ParseResult &result = try_parse(args, "argparse_test source -k x --name abc sub --level");
+    assert(result.errors.size() == 2);
+    assert(result.errors[0].key == "l,level" && result.errors[0].code == argparse::ErrorCode::MISSING_VALUE);     // the errors of the subcommand come first
+    assert(result.errors[1].key == "k" && result.errors[1].code == argparse::ErrorCode::INVALID_VALUE);
+    assert(!args.sub.is_valid && !args.is_valid);
+
+    const argparse::ParseResult &valid = try_parse(args, "argparse_test source --name abc sub --level 3");
+    assert(valid.ok() && args.sub.is_valid && args.sub.level == 3);
+}
+
+void TEST_HELP() {
+    Args args;
+    const argparse::ParseResult &result = try_parse(args, "argparse_test --help");  // does not print the help and exit
+    assert(result.errors.size() == 2 && result.errors[0].code == argparse::ErrorCode::MISSING_ARGUMENT && result.errors[1].key == "name");
+}
+
+void TEST_FILE_ERRORS() {
+    struct FileArgs : public argparse::Args {
+        argparse::mapped_file &file     = kwarg("f,file", "A file that is mapped while parsing");
+    };
+
+    FileArgs args;
+    const argparse::ParseResult &result = try_parse(args, "argparse_test -f /argparse_test_missing/file.txt");   // reported instead of aborting
+    assert(result.errors.size() == 1 && result.errors[0].code == argparse::ErrorCode::CUSTOM && result.errors[0].value == "/argparse_test_missing/file.txt");
+    assert(result.errors[0].message().find("could not open file: ") != std::string::npos && !args.file.is_open());
+
+    struct ArrayArgs : public argparse::Args {
+        std::vector<float> &weights                 = kwarg("w,weights", "Weights that are loaded from a binary file");
+        argparse::mapped_span<float> &mapped        = kwarg("m,mapped", "Weights used in place").set_default("");
+    };
+
+    const std::string odd = (std::filesystem::temp_directory_path() / "argparse_test_noexcept_odd.bin").string();
+    std::ofstream(odd, std::ios::binary) << "12345";
+    ArrayArgs array_args;
+    const argparse::ParseResult &array_result = try_parse(array_args, "argparse_test -w @@/argparse_test_missing/weights.npy -m " + odd);
+    assert(array_result.errors.size() == 2 && array_result.errors[0].code == argparse::ErrorCode::CUSTOM && array_result.errors[1].code == argparse::ErrorCode::CUSTOM);
+    assert(array_result.errors[0].message().find("could not open file: ") != std::string::npos);
+    assert(array_result.errors[1].message().find("not a multiple of the element size") != std::string::npos && array_args.mapped.empty());
+    std::filesystem::remove(odd);
+}
+
+// A model of which only the path is checked while parsing
+struct Model {
+    std::string path;
+
+    explicit Model(std::string_view v) : path(v) {}
+    static bool validate(std::string_view v) { return v.size() > 4 && v.substr(v.size() - 4) == ".bin"; }
+};
+
+void TEST_DEFERRED_ERRORS() {
+    struct DeferredArgs : public argparse::Args {
+        argparse::deferred<Model> &model    = kwarg("m,model", "A model that is loaded when it is used");
+    };
+
+    DeferredArgs args;
+    const argparse::ParseResult &result = try_parse(args, "argparse_test -m model.txt");    // rejected by the check instead of aborting
+    assert(result.errors.size() == 1 && result.errors[0].code == argparse::ErrorCode::INVALID_VALUE && result.errors[0].value == "model.txt");
+    assert(!args.model.has_value());
+
+    DeferredArgs valid_args;
+    assert(try_parse(valid_args, "argparse_test -m model.bin").ok());
+    assert(valid_args.model.raw() == "model.bin" && valid_args.model->path == "model.bin");
+}
+
+void TEST_PARALLEL() {
+    // threads are started without exceptions, and the work of those that could not be started is done by the others
+    std::vector<int> visited(10000, 0);
+    argparse::parallel_for(visited.size(), [&](size_t i) { visited[i]++; }, 4);
+    assert(std::count(visited.begin(), visited.end(), 1) == (long)visited.size());
+}
+
+int main(int argc, char* argv[]) {
+    TEST_VALID();
+    TEST_ALL_ERRORS();
+    TEST_SUBCOMMAND_ERRORS();
+    TEST_HELP();
+    TEST_FILE_ERRORS();
+    TEST_DEFERRED_ERRORS();
+    TEST_PARALLEL();
+
+    std::cout << "finished all tests" << std::endl;
+    return 0;
+}